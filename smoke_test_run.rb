@@ -154,5 +154,64 @@ puts "Found #{installed_products.size} installed products: #{installed_products.
 puts "Found #{available_products.size} available products: #{available_products.map{|p| p["display_name"]}}"
 puts "OK"
 
+# the statistics builtins
+puts "Checking Pkg.BuiltinStats..."
+stats = Yast::Pkg.BuiltinStats
+raise "Pkg.BuiltinStats failed!" unless stats
+raise "Pkg.SourceLoad not found in the statistics" unless stats["SourceLoad"]
+puts "OK (#{stats.size} builtins called)"
+
+puts "Checking Pkg.SourceLoadStats..."
+raise "Pkg.SourceLoadStats failed!" unless Yast::Pkg.SourceLoadStats
+puts "OK"
+
+puts "Checking Pkg.PoolStats..."
+pool_stats = Yast::Pkg.PoolStats
+raise "Pkg.PoolStats failed!" unless pool_stats
+raise "Empty pool reported!" unless pool_stats["solvables"] > 0
+puts "OK (#{pool_stats["solvables"]} solvables)"
+
+puts "Checking Pkg.DownloadStats..."
+raise "Pkg.DownloadStats failed!" unless Yast::Pkg.DownloadStats
+puts "OK"
+
+puts "Checking Pkg.SetDownloadAreaLimit and Pkg.DownloadAreaStats..."
+raise "Pkg.SetDownloadAreaLimit failed!" unless Yast::Pkg.SetDownloadAreaLimit(0)
+area_stats = Yast::Pkg.DownloadAreaStats
+raise "Pkg.DownloadAreaStats failed!" unless area_stats
+raise "Unexpected download area limit: #{area_stats["limit"]}" unless area_stats["limit"] == 0
+puts "OK"
+
+# nothing to download, only the arguments are checked
+puts "Checking Pkg.SourceProvideFiles..."
+provided = Yast::Pkg.SourceProvideFiles(repos.first, 1, [], {})
+raise "Unexpected result: #{provided.inspect}" unless provided == {}
+puts "OK"
+
+puts "Checking Pkg.ProvidePackages..."
+require "tmpdir"
+Dir.mktmpdir do |dir|
+  exported = Yast::Pkg.ProvidePackages(repos.first, [], dir, {})
+  raise "Unexpected result: #{exported.inspect}" unless exported == {}
+end
+puts "OK"
+
+# no package is selected to install
+puts "Checking Pkg.PrefetchPackages..."
+prefetched = Yast::Pkg.PrefetchPackages({})
+raise "Pkg.PrefetchPackages failed!" unless prefetched
+raise "Unexpected result: #{prefetched.inspect}" unless prefetched["packages"] == 0
+puts "OK"
+
+# run an operation in background
+puts "Checking Pkg.StartAsync..."
+handle = Yast::Pkg.StartAsync(:target_load, [])
+raise "Pkg.StartAsync failed!" unless handle
+raise "Pkg.AsyncWait failed!" unless Yast::Pkg.AsyncWait(handle, -1)
+status = Yast::Pkg.AsyncPoll(handle)
+raise "Pkg.AsyncPoll failed!" unless status
+raise "Unexpected result: #{status.inspect}" unless status["state"] == :finished && status["result"] == true
+puts "OK"
+
 # scan y2log for errors
 check_y2log
@@ -0,0 +1,265 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	$Id$
+   Summary:     Asynchronous operations (running in a worker thread)
+   Namespace:   Pkg
+*/
+
+#include <PkgFunctions.h>
+#include "AsyncOperation.h"
+#include "log.h"
+
+#include <ycp/YCPBoolean.h>
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPString.h>
+#include <ycp/YCPSymbol.h>
+#include <ycp/YCPList.h>
+#include <ycp/YCPMap.h>
+#include <ycp/YCPVoid.h>
+
+/**
+ * @builtin StartAsync
+ * @short Start a long running operation in background
+ * @description
+ * Starts the operation in a worker thread and returns immediately. The YCP callbacks
+ * requested by the operation are evaluated in AsyncPoll() and AsyncWait() calls,
+ * the operation waits until the callback is evaluated. The progress callbacks
+ * are not evaluated, the last reported values are returned by AsyncPoll().
+ *
+ * Only one operation can run at once. While it is running the other builtins
+ * (except the Async* builtins) wait until the operation is finished (the callbacks
+ * requested by the operation are evaluated meanwhile), only the callbacks evaluated
+ * for the operation can call them immediately.
+ *
+ * Supported operations:
+ * `source_load (SourceLoad()),
+ * `refresh ([ integer repo_id ], SourceRefreshNow()),
+ * `service_refresh ([ string alias ], ServiceRefresh()),
+ * `target_initialize ([ string root ], TargetInitialize()),
+ * `target_load (TargetLoad()),
+ * `commit ([ map config ], Commit())
+ *
+ * @param symbol operation the operation
+ * @param list args arguments of the operation
+ * @return integer handle of the operation, nil on error
+ */
+YCPValue PkgFunctions::StartAsync(const YCPSymbol& operation, const YCPList& args)
+{
+    if (operation.isNull())
+    {
+	y2error("Missing operation");
+	return YCPVoid();
+    }
+
+    std::string name = operation->symbol();
+
+    for (AsyncOperations::const_iterator it = async_operations.begin(); it != async_operations.end(); ++it)
+    {
+	if (!it->second->finished())
+	{
+	    y2error("Async operation %lld (%s) is still running", it->first, it->second->name().c_str());
+	    _last_error.setLastError(_("Another operation is still running."));
+	    return YCPVoid();
+	}
+    }
+
+    YCPValue arg = (!args.isNull() && args->size() > 0) ? args->value(0) : YCPVoid();
+    AsyncOperation::Task task;
+
+    // the worker thread must not use any YCP value, the arguments are converted
+    // to plain values here and the result is converted to YCP in the main thread
+    auto boolean_result = [](bool ret) -> AsyncOperation::Result {
+	return [ret] { return YCPBoolean(ret); };
+    };
+
+    if (name == "source_load")
+    {
+	task = [this, boolean_result] { return boolean_result(SourceLoadInternal()); };
+    }
+    else if (name == "refresh" && arg->isInteger())
+    {
+	RepoId repo = arg->asInteger()->value();
+	task = [this, repo, boolean_result] { return boolean_result(SourceRefreshHelper(repo)); };
+    }
+    else if (name == "service_refresh" && arg->isString())
+    {
+	std::string alias(arg->asString()->value());
+	task = [this, alias, boolean_result] { return boolean_result(ServiceRefreshHelper(alias)); };
+    }
+    else if (name == "target_initialize" && arg->isString())
+    {
+	std::string root(arg->asString()->value());
+	task = [this, root, boolean_result] { return boolean_result(TargetInitializeImpl(root, std::string())); };
+    }
+    else if (name == "target_load")
+    {
+	task = [this, boolean_result] { return boolean_result(TargetLoadImpl()); };
+    }
+    else if (name == "commit")
+    {
+	unsigned pipeline_depth = 0;
+
+	// the invalid config is reported immediately
+	if (!CommitOptions(arg->isMap() ? arg->asMap() : YCPMap(), pipeline_depth))
+	    return YCPVoid();
+
+	task = [this, pipeline_depth] () -> AsyncOperation::Result {
+	    PlainValue ret(CommitImpl(pipeline_depth));
+	    return [ret] { return ret.toYCP(); };
+	};
+    }
+    else
+    {
+	y2error("Unsupported async operation or invalid arguments: %s, %s",
+	    name.c_str(), args.isNull() ? "nil" : args->toString().c_str());
+	_last_error.setLastError(_("Invalid operation."), name);
+	return YCPVoid();
+    }
+
+    AsyncOperation *op = new AsyncOperation(++async_last_id, name, task);
+    async_operations[op->id()] = op;
+    op->start();
+
+    return YCPInteger(op->id());
+}
+
+AsyncOperation* PkgFunctions::findAsyncOperation(const YCPInteger &handle)
+{
+    if (handle.isNull())
+    {
+	y2error("Missing operation handle");
+	return NULL;
+    }
+
+    AsyncOperations::iterator it = async_operations.find(handle->value());
+
+    if (it == async_operations.end())
+    {
+	y2error("Invalid operation handle: %lld", handle->value());
+	_last_error.setLastError(_("Invalid operation handle."));
+	return NULL;
+    }
+
+    return it->second;
+}
+
+/**
+ * @builtin AsyncPoll
+ * @short Get the state of an asynchronous operation
+ * @description
+ * Evaluates the pending callback requested by the operation (if any) and returns
+ * the current state. When the operation is finished the result is returned
+ * and the handle is released.
+ *
+ * @param integer handle handle returned by StartAsync()
+ * @return map $[ "id" : integer, "operation" : string, "state" : `running|`finished|`cancelled,
+ *   "waiting" : boolean (waiting for a callback), "progress" : $[ "ProgressDownload" : [ 42, 1024, 2048 ], ...],
+ *   "result" : any (the result of the operation, only when finished) ], nil on error
+ */
+YCPValue PkgFunctions::AsyncPoll(const YCPInteger& handle)
+{
+    AsyncOperation *op = findAsyncOperation(handle);
+
+    if (!op)
+	return YCPVoid();
+
+    op->poll();
+
+    YCPMap ret(op->status());
+
+    if (op->finished())
+    {
+	async_operations.erase(op->id());
+	delete op;
+    }
+
+    return ret;
+}
+
+/**
+ * @builtin AsyncWait
+ * @short Wait for an asynchronous operation
+ * @description
+ * Waits until the operation is finished, the callbacks requested by the operation
+ * are evaluated meanwhile. Use AsyncPoll() to get the result.
+ *
+ * @param integer handle handle returned by StartAsync()
+ * @param integer timeout timeout in milliseconds, a negative value means no timeout
+ * @return boolean true if the operation is finished, false if the timeout expired
+ */
+YCPValue PkgFunctions::AsyncWait(const YCPInteger& handle, const YCPInteger& timeout)
+{
+    AsyncOperation *op = findAsyncOperation(handle);
+
+    if (!op)
+	return YCPBoolean(false);
+
+    return YCPBoolean(op->wait(timeout.isNull() ? -1LL : timeout->value()));
+}
+
+/**
+ * @builtin AsyncCancel
+ * @short Cancel an asynchronous operation
+ * @description
+ * The operation is aborted at the next progress report, it still needs to be
+ * polled or waited for, the pending callbacks are evaluated.
+ *
+ * @param integer handle handle returned by StartAsync()
+ * @return boolean true on success
+ */
+YCPValue PkgFunctions::AsyncCancel(const YCPInteger& handle)
+{
+    AsyncOperation *op = findAsyncOperation(handle);
+
+    if (!op)
+	return YCPBoolean(false);
+
+    op->cancel();
+
+    return YCPBoolean(true);
+}
+
+void PkgFunctions::AsyncWaitIdle(const std::string &builtin)
+{
+    // the builtins managing the operations are always allowed,
+    // BuiltinStats only reads the statistics collected in the main thread
+    if (builtin.compare(0, 5, "Async") == 0 || builtin == "BuiltinStats")
+	return;
+
+    bool waited = true;
+
+    // the callbacks evaluated meanwhile might change the list, start again after waiting
+    while (waited)
+    {
+	waited = false;
+
+	for (AsyncOperations::const_iterator it = async_operations.begin(); it != async_operations.end(); ++it)
+	{
+	    // calling from a callback is OK, the worker thread is waiting for the result
+	    if (!it->second->finished() && !it->second->serving())
+	    {
+		y2milestone("Pkg::%s waits for async operation %lld (%s)", builtin.c_str(),
+		    it->first, it->second->name().c_str());
+		it->second->wait(-1);
+		waited = true;
+		break;
+	    }
+	}
+    }
+}
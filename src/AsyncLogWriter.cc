@@ -0,0 +1,389 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	AsyncLogWriter.cc
+   Summary:     Asynchronous writer of the libzypp log lines to y2log
+*/
+
+#include "AsyncLogWriter.h"
+#include "log.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <cstdarg>
+#include <new>
+#include <type_traits>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+bool y2_log_in_thread()
+{
+    // the main thread ID is the process ID
+    static thread_local int in_thread = -1;
+
+    if (in_thread < 0)
+	in_thread = ::syscall(SYS_gettid) != ::getpid();
+
+    return in_thread;
+}
+
+void y2_logger_thread(loglevel_t level, const char *component, const char *file,
+    int line, const char *func, const char *format, ...)
+{
+    // the host name does not change
+    static const std::string host = [] {
+	char buffer[256] = "";
+	::gethostname(buffer, sizeof(buffer) - 1);
+	return std::string(buffer);
+    }();
+
+    char message[4096];
+    va_list ap;
+    va_start(ap, format);
+    ::vsnprintf(message, sizeof(message), format, ap);
+    va_end(ap);
+
+    char date[32];
+    time_t now = ::time(NULL);
+    struct tm tm;
+    ::localtime_r(&now, &tm);
+    ::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &tm);
+
+    const char *base = ::strrchr(file, '/');
+
+    // the same format as y2log
+    char prefix[512];
+    ::snprintf(prefix, sizeof(prefix), "%s <%d> %s(%d) [%s] %s(%s):%d ", date, (int)level,
+	host.c_str(), (int)::getpid(), component, base ? base + 1 : file, func, line);
+
+    AsyncLogWriter::instance().write(std::string(prefix) + message);
+}
+
+AsyncLogWriter& AsyncLogWriter::instance()
+{
+    // intentionally never deleted, libzypp might log from global destructors
+    // (the storage keeps the cache line alignment of the queue positions)
+    static std::aligned_storage<sizeof(AsyncLogWriter), alignof(AsyncLogWriter)>::type storage;
+    static AsyncLogWriter *writer = new (&storage) AsyncLogWriter();
+    return *writer;
+}
+
+AsyncLogWriter::AsyncLogWriter()
+    : _enqueue_pos(0), _dequeue_pos(0), _running(false), _sleeping(false), _child(false), _fd(-1)
+{
+    for (unsigned i = 0; i < ring_size; ++i)
+	_ring[i].sequence.store(i, std::memory_order_relaxed);
+
+    // used also by the other threads in the synchronous mode
+    _file = get_log_filename();
+    _fd = _file.empty() ? -1 : ::open(_file.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+
+    // the mutexes are used by the other threads also in the synchronous mode
+    ::pthread_atfork(&AsyncLogWriter::forkPrepare, &AsyncLogWriter::forkParent, &AsyncLogWriter::forkChild);
+
+    const char *sync = ::getenv("Y2PKG_SYNC_LOG");
+
+    if (sync && ::strcmp(sync, "1") == 0)
+    {
+	y2milestone("Y2PKG_SYNC_LOG is set, writing the ZYPP log synchronously");
+	return;
+    }
+
+    if (_fd < 0)
+    {
+	y2milestone("Cannot open the log file '%s', writing the ZYPP log synchronously", _file.c_str());
+	return;
+    }
+
+    ::atexit(&AsyncLogWriter::atExit);
+
+    _running = true;
+    _thread = std::thread(&AsyncLogWriter::run, this);
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    stop();
+}
+
+void AsyncLogWriter::forkPrepare()
+{
+    AsyncLogWriter &writer = instance();
+
+    // the writer thread never holds both, the order does not matter
+    writer._drain_mutex.lock();
+    writer._mutex.lock();
+}
+
+void AsyncLogWriter::forkParent()
+{
+    AsyncLogWriter &writer = instance();
+
+    writer._mutex.unlock();
+    writer._drain_mutex.unlock();
+}
+
+void AsyncLogWriter::forkChild()
+{
+    AsyncLogWriter &writer = instance();
+
+    // locked by forkPrepare() in the forking thread, the only thread in the child
+    writer._mutex.unlock();
+    writer._drain_mutex.unlock();
+
+    // the writer thread is not copied to the child, the queued lines
+    // are written by the parent, write the new lines synchronously
+    writer._child = true;
+    writer._running = false;
+}
+
+void AsyncLogWriter::atExit()
+{
+    instance().stop();
+}
+
+// see http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+bool AsyncLogWriter::push(const std::string &line)
+{
+    unsigned long pos = _enqueue_pos.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+	Cell &cell = _ring[pos & (ring_size - 1)];
+	unsigned long seq = cell.sequence.load(std::memory_order_acquire);
+	long diff = (long)seq - (long)pos;
+
+	if (diff == 0)
+	{
+	    if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+	    {
+		cell.line = line;
+		cell.sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	    }
+	}
+	// the buffer is full
+	else if (diff < 0)
+	    return false;
+	else
+	    pos = _enqueue_pos.load(std::memory_order_relaxed);
+    }
+}
+
+bool AsyncLogWriter::pop(std::string &line)
+{
+    unsigned long pos = _dequeue_pos.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+	Cell &cell = _ring[pos & (ring_size - 1)];
+	unsigned long seq = cell.sequence.load(std::memory_order_acquire);
+	long diff = (long)seq - (long)(pos + 1);
+
+	if (diff == 0)
+	{
+	    if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+	    {
+		line.swap(cell.line);
+		cell.line.clear();
+		cell.sequence.store(pos + ring_size, std::memory_order_release);
+		return true;
+	    }
+	}
+	// the buffer is empty
+	else if (diff < 0)
+	    return false;
+	else
+	    pos = _dequeue_pos.load(std::memory_order_relaxed);
+    }
+}
+
+std::string AsyncLogWriter::timeTag()
+{
+    struct timespec ts;
+    struct tm tm;
+    char buffer[32];
+
+    ::clock_gettime(CLOCK_REALTIME, &ts);
+    ::localtime_r(&ts.tv_sec, &tm);
+    ::snprintf(buffer, sizeof(buffer), " {%02d:%02d:%02d.%03ld}", tm.tm_hour, tm.tm_min, tm.tm_sec, ts.tv_nsec / 1000000);
+
+    return buffer;
+}
+
+void AsyncLogWriter::writeOut(const std::string &data)
+{
+    // the log has been rotated by y2log, write to the new file
+    struct stat file_st, fd_st;
+
+    if (_fd >= 0 && ::stat(_file.c_str(), &file_st) == 0 && ::fstat(_fd, &fd_st) == 0
+	&& (file_st.st_ino != fd_st.st_ino || file_st.st_dev != fd_st.st_dev))
+    {
+	int fd = ::open(_file.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+
+	// keep the descriptor number
+	if (fd >= 0)
+	{
+	    ::dup3(fd, _fd, O_CLOEXEC);
+	    ::close(fd);
+	}
+    }
+
+    const char *ptr = data.data();
+    size_t size = data.size();
+
+    while (size > 0)
+    {
+	ssize_t written = ::write(_fd >= 0 ? _fd : STDERR_FILENO, ptr, size);
+
+	if (written < 0)
+	{
+	    if (errno == EINTR)
+		continue;
+
+	    // cannot log the error, just do not block
+	    return;
+	}
+
+	ptr += written;
+	size -= written;
+    }
+}
+
+unsigned AsyncLogWriter::drain()
+{
+    std::lock_guard<std::mutex> lock(_drain_mutex);
+    return drainLocked();
+}
+
+unsigned AsyncLogWriter::drainLocked()
+{
+    unsigned ret = 0;
+    std::string batch;
+    std::string line;
+
+    while (pop(line))
+    {
+	batch += line;
+	batch += '\n';
+	++ret;
+
+	if (ret % batch_size == 0)
+	{
+	    writeOut(batch);
+	    batch.clear();
+	}
+    }
+
+    if (!batch.empty())
+	writeOut(batch);
+
+    return ret;
+}
+
+void AsyncLogWriter::run()
+{
+    while (_running)
+    {
+	if (drain() > 0)
+	    continue;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_sleeping = true;
+
+	// the timeout covers a wakeup lost between the check and the wait
+	_wakeup.wait_for(lock, std::chrono::milliseconds(100), [this] {
+	    return !_running || _enqueue_pos.load() != _dequeue_pos.load();
+	});
+
+	_sleeping = false;
+    }
+}
+
+void AsyncLogWriter::write(const std::string &line)
+{
+    if (_running)
+    {
+	if (push(line + timeTag()))
+	{
+	    // stop() might have done the final drain meanwhile, write the line here
+	    if (!_running)
+		flush();
+	    else if (_sleeping)
+		_wakeup.notify_one();
+
+	    return;
+	}
+
+	// the buffer is full, write the queued lines first to keep the order
+	std::lock_guard<std::mutex> lock(_drain_mutex);
+	drainLocked();
+	writeOut(line + "\n");
+	return;
+    }
+
+    // y2lograw() must not be called from the other threads
+    if (y2_log_in_thread())
+    {
+	writeDirect(line + "\n");
+	return;
+    }
+
+    y2lograw((line + "\n").c_str());
+}
+
+void AsyncLogWriter::writeDirect(const std::string &data)
+{
+    std::lock_guard<std::mutex> lock(_drain_mutex);
+    writeOut(data);
+}
+
+void AsyncLogWriter::flush()
+{
+    // the queued lines belong to the parent process
+    if (_child)
+	return;
+
+    drain();
+}
+
+void AsyncLogWriter::stop()
+{
+    if (_child)
+	return;
+
+    if (_thread.joinable())
+    {
+	{
+	    std::lock_guard<std::mutex> lock(_mutex);
+	    _running = false;
+	}
+
+	_wakeup.notify_one();
+	_thread.join();
+    }
+
+    drain();
+}
@@ -0,0 +1,143 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	AsyncLogWriter.h
+   Summary:     Asynchronous writer of the libzypp log lines to y2log
+*/
+
+#ifndef AsyncLogWriter_h
+#define AsyncLogWriter_h
+
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * Writes the libzypp log lines to y2log from a separate thread so the thread
+ * running the solver, the refresh or the commit does not wait for the disk.
+ *
+ * The lines are passed via a bounded lock-free ring buffer (multiple producers,
+ * a single consumer), the writer thread concatenates the pending lines and
+ * appends them to the y2log file with a single write() call. y2log itself is
+ * not thread safe (e.g. the log rotation), the writer thread does not call it,
+ * it uses its own file descriptor (reopened when the log has been rotated).
+ * If the buffer is full the line is written synchronously so nothing is lost.
+ *
+ * The Pkg messages logged from the other threads than the main one are passed
+ * the same way (see y2_logger_thread() in log.h), without the writer thread
+ * they are appended to the log file directly (serialized by a mutex).
+ *
+ * The queued lines might be written after the Pkg messages logged later,
+ * each queued line is tagged with the time it has been logged (with milliseconds,
+ * e.g. "{12:30:45.123}" at the end) so the original order can be reconstructed.
+ * The queue is flushed before logging a backtrace, when the module is destroyed
+ * and at exit.
+ *
+ * Set Y2PKG_SYNC_LOG=1 in the environment to write everything synchronously
+ * (the same when the log is not written to a file).
+ */
+class AsyncLogWriter
+{
+    public:
+
+	static AsyncLogWriter& instance();
+
+	// queue a log line (without the trailing new line), can be called from any thread
+	void write(const std::string &line);
+
+	// write all pending lines and wait until they are written
+	void flush();
+
+	// flush and stop the writer thread, the next lines are written synchronously
+	void stop();
+
+    private:
+
+	AsyncLogWriter();
+	~AsyncLogWriter();
+
+	// not copyable
+	AsyncLogWriter(const AsyncLogWriter&);
+	AsyncLogWriter& operator=(const AsyncLogWriter&);
+
+	bool push(const std::string &line);
+	bool pop(std::string &line);
+
+	// write all currently queued lines, returns the number of lines
+	unsigned drain();
+	// the same, _drain_mutex must be locked
+	unsigned drainLocked();
+
+	// append the data to the log file, reopen the file if it has been rotated
+	// (to stderr if there is no log file)
+	void writeOut(const std::string &data);
+
+	// write a line from a thread when the writer thread is not running
+	void writeDirect(const std::string &data);
+
+	// the "{HH:MM:SS.mmm}" tag with the current time
+	static std::string timeTag();
+
+	void run();
+
+	// pthread_atfork() handlers, the mutexes are locked while forking so the child
+	// does not get a mutex locked by a thread which does not exist there
+	static void forkPrepare();
+	static void forkParent();
+	// the writer thread does not exist in the child
+	static void forkChild();
+
+	// atexit() handler
+	static void atExit();
+
+	static const unsigned ring_size = 4096;	// must be a power of 2
+	static const unsigned batch_size = 256;
+
+	struct Cell
+	{
+	    std::atomic<unsigned long> sequence;
+	    std::string line;
+	};
+
+	Cell _ring[ring_size];
+
+	// keep the producer and the consumer positions in different cache lines
+	alignas(64) std::atomic<unsigned long> _enqueue_pos;
+	alignas(64) std::atomic<unsigned long> _dequeue_pos;
+
+	std::atomic<bool> _running;
+	std::atomic<bool> _sleeping;
+	// set in a forked child process
+	std::atomic<bool> _child;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeup;
+
+	// serializes the consumers (the writer thread and the flushing thread)
+	std::mutex _drain_mutex;
+
+	std::thread _thread;
+
+	// the y2log file and its descriptor (-1 = no log file)
+	std::string _file;
+	int _fd;
+};
+
+#endif // AsyncLogWriter_h
@@ -0,0 +1,234 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	AsyncOperation.cc
+   Summary:     A Pkg builtin running in a worker thread
+*/
+
+#include "AsyncOperation.h"
+#include "log.h"
+
+#include <ycp/YCPBoolean.h>
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPString.h>
+#include <ycp/YCPSymbol.h>
+#include <ycp/YCPList.h>
+#include <ycp/YCPVoid.h>
+
+#include <chrono>
+#include <exception>
+
+// the operation running in the current thread
+static thread_local AsyncOperation *current_operation = NULL;
+
+AsyncOperation::AsyncOperation(long long id, const std::string &name, const Task &task)
+    : _id(id), _name(name), _task(task), _finished(false), _cancelled(false),
+    _abandoned(false), _serving(false), _request(NULL), _request_done(false)
+{
+}
+
+AsyncOperation::~AsyncOperation()
+{
+    if (_thread.joinable())
+    {
+	{
+	    std::lock_guard<std::mutex> lock(_mutex);
+
+	    if (!_finished)
+		y2warning("Async operation %lld (%s) is still running, aborting it", _id, _name.c_str());
+
+	    _cancelled = true;
+	    _abandoned = true;
+	}
+
+	_cond.notify_all();
+	_thread.join();
+    }
+}
+
+AsyncOperation* AsyncOperation::current()
+{
+    return current_operation;
+}
+
+void AsyncOperation::forkedChild()
+{
+    current_operation = NULL;
+}
+
+void AsyncOperation::start()
+{
+    y2milestone("Starting async operation %lld (%s)", _id, _name.c_str());
+    _thread = std::thread(&AsyncOperation::run, this);
+}
+
+void AsyncOperation::run()
+{
+    current_operation = this;
+
+    Result ret;
+
+    try
+    {
+	ret = _task();
+    }
+    catch (const std::exception &e)
+    {
+	y2error("Async operation %lld (%s) failed: %s", _id, _name.c_str(), e.what());
+    }
+    catch (...)
+    {
+	y2error("Async operation %lld (%s) failed", _id, _name.c_str());
+    }
+
+    current_operation = NULL;
+
+    y2milestone("Async operation %lld (%s) finished", _id, _name.c_str());
+
+    {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_result = ret;
+	_finished = true;
+    }
+
+    _cond.notify_all();
+}
+
+bool AsyncOperation::wait(long long timeout_ms)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+	+ std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true)
+    {
+	if (_request != NULL)
+	{
+	    const std::function<void ()> *request = _request;
+	    _request = NULL;
+	    _serving = true;
+
+	    // evaluate the callback without the lock, it might call Pkg builtins
+	    lock.unlock();
+	    (*request)();
+	    lock.lock();
+
+	    _serving = false;
+	    _request_done = true;
+	    _cond.notify_all();
+	    continue;
+	}
+
+	if (_finished)
+	    return true;
+
+	if (timeout_ms < 0)
+	    _cond.wait(lock);
+	else if (_cond.wait_until(lock, deadline) == std::cv_status::timeout
+	    && _request == NULL && !_finished)
+	    return false;
+    }
+}
+
+bool AsyncOperation::callOnMain(const std::function<void ()> &func)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_abandoned)
+	return false;
+
+    _request = &func;
+    _request_done = false;
+    _cond.notify_all();
+
+    _cond.wait(lock, [this] { return _request_done || _abandoned; });
+
+    if (!_request_done)
+    {
+	// the operation is being destroyed, the callback will not be evaluated
+	_request = NULL;
+	return false;
+    }
+
+    return true;
+}
+
+bool AsyncOperation::progress(const std::string &callback, const std::vector<long long> &values)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _progress[callback] = values;
+    return !_cancelled;
+}
+
+void AsyncOperation::cancel()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_finished)
+    {
+	y2milestone("Cancelling async operation %lld (%s)", _id, _name.c_str());
+	_cancelled = true;
+    }
+}
+
+bool AsyncOperation::cancelled() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cancelled;
+}
+
+bool AsyncOperation::finished() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _finished;
+}
+
+bool AsyncOperation::serving() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _serving;
+}
+
+YCPMap AsyncOperation::status()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    YCPMap ret;
+    ret->add(YCPString("id"), YCPInteger(_id));
+    ret->add(YCPString("operation"), YCPString(_name));
+    ret->add(YCPString("state"), YCPSymbol(_finished ? (_cancelled ? "cancelled" : "finished") : "running"));
+    ret->add(YCPString("waiting"), YCPBoolean(_request != NULL));
+
+    YCPMap progress;
+    for (Progress::const_iterator it = _progress.begin(); it != _progress.end(); ++it)
+    {
+	YCPList values;
+
+	for (std::vector<long long>::const_iterator v = it->second.begin(); v != it->second.end(); ++v)
+	    values->add(YCPInteger(*v));
+
+	progress->add(YCPString(it->first), values);
+    }
+    ret->add(YCPString("progress"), progress);
+
+    if (_finished)
+	ret->add(YCPString("result"), _result ? _result() : YCPVoid());
+
+    return ret;
+}
@@ -0,0 +1,156 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	AsyncOperation.h
+   Summary:     A Pkg builtin running in a worker thread
+*/
+
+#ifndef AsyncOperation_h
+#define AsyncOperation_h
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <ycp/YCPValue.h>
+#include <ycp/YCPMap.h>
+
+/**
+ * Runs a long running builtin (SourceLoad, Commit, ...) in a worker thread.
+ *
+ * The YCP values are not thread safe, the worker thread must not create,
+ * copy or destroy any YCP value. The task gets its arguments as plain C++
+ * values and returns a function which converts its plain result to YCP,
+ * it is called in the main thread. The YCP callbacks are completely evaluated
+ * in the main thread (see YCPCallbacks::call()), the worker thread passes them
+ * to the main thread and waits until they are evaluated in wait() or poll().
+ * The progress callbacks are not evaluated at all, only the last reported values
+ * are remembered and returned by status(), the progress callbacks return false
+ * (abort) after cancel() is called.
+ */
+class AsyncOperation
+{
+    public:
+
+	// converts the plain result of the task to YCP, called in the main thread
+	typedef std::function<YCPValue ()> Result;
+	// the task, called in the worker thread
+	typedef std::function<Result ()> Task;
+
+	AsyncOperation(long long id, const std::string &name, const Task &task);
+
+	// cancels the operation and waits for the worker thread
+	~AsyncOperation();
+
+	long long id() const { return _id; }
+	const std::string& name() const { return _name; }
+
+	// start the worker thread
+	void start();
+
+	/**
+	 * Evaluate the callbacks requested by the worker thread
+	 * until the operation is finished or the timeout expires.
+	 * @param timeout_ms timeout in milliseconds, negative value means no timeout
+	 * @return true if the operation is finished
+	 */
+	bool wait(long long timeout_ms);
+
+	// evaluate the pending callback request (if any), do not wait
+	bool poll() { return wait(0); }
+
+	// request abort, the operation stops at the next progress callback
+	void cancel();
+
+	bool cancelled() const;
+	bool finished() const;
+
+	// is the main thread evaluating a callback for the worker?
+	bool serving() const;
+
+	// $[ "id" : integer, "operation" : string, "state" : `running|`finished|`cancelled,
+	//   "waiting" : boolean, "progress" : $[ "ProgressDownload" : [ 42, ... ], ... ],
+	//   "result" : any ], call it only in the main thread
+	YCPMap status();
+
+	/**
+	 * The operation running in the current thread,
+	 * NULL in the main thread.
+	 */
+	static AsyncOperation* current();
+
+	/**
+	 * Forget the current operation in a forked child process,
+	 * the worker thread does not exist there.
+	 */
+	static void forkedChild();
+
+	/**
+	 * Evaluate a function (a YCP callback) in the main thread,
+	 * blocks until it is evaluated, called from the worker thread.
+	 * @return false if the function has not been evaluated
+	 *   (the operation is being destroyed)
+	 */
+	bool callOnMain(const std::function<void ()> &func);
+
+	/**
+	 * Remember the progress reported by a progress callback,
+	 * called from the worker thread.
+	 * @return false if the operation has been cancelled
+	 */
+	bool progress(const std::string &callback, const std::vector<long long> &values);
+
+    private:
+
+	// not copyable
+	AsyncOperation(const AsyncOperation&);
+	AsyncOperation& operator=(const AsyncOperation&);
+
+	void run();
+
+	long long _id;
+	std::string _name;
+	Task _task;
+
+	std::thread _thread;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _cond;
+
+	bool _finished;
+	bool _cancelled;
+	// do not evaluate the callbacks anymore (the object is being destroyed)
+	bool _abandoned;
+	bool _serving;
+
+	// the result of the task, converted to YCP in status()
+	Result _result;
+
+	// the pending callback request from the worker
+	const std::function<void ()> *_request;
+	bool _request_done;
+
+	typedef std::map<std::string, std::vector<long long> > Progress;
+	Progress _progress;
+};
+
+#endif // AsyncOperation_h
@@ -0,0 +1,159 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	CallStats.cc
+   Summary:     Call count and timing statistics of the Pkg builtins
+*/
+
+#include "CallStats.h"
+#include "log.h"
+
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPString.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+
+CallStats::Timer::~Timer()
+{
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - _start;
+    CallStats::instance().record(_name,
+	std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+CallStats& CallStats::instance()
+{
+    // intentionally never deleted, the statistics are dumped from a global
+    // destructor (~Y2CCPkg) and the destruction order is not defined
+    static CallStats *stats = new CallStats();
+    return *stats;
+}
+
+unsigned CallStats::bucket(unsigned long long usec)
+{
+    if (usec < sub_buckets)
+	return usec;
+
+    // position of the highest bit
+    unsigned exponent = 63 - __builtin_clzll(usec);
+    unsigned shift = exponent - sub_bucket_bits;
+    unsigned sub = (usec >> shift) & (sub_buckets - 1);
+
+    return sub_buckets + shift * sub_buckets + sub;
+}
+
+unsigned long long CallStats::bucketHighest(unsigned index)
+{
+    if (index < sub_buckets)
+	return index;
+
+    unsigned shift = (index - sub_buckets) / sub_buckets;
+    unsigned long long sub = (index - sub_buckets) % sub_buckets;
+    unsigned long long lowest = (sub_buckets + sub) << shift;
+
+    return lowest + (1ULL << shift) - 1;
+}
+
+unsigned long long CallStats::Entry::percentile(unsigned p) const
+{
+    if (count == 0)
+	return 0;
+
+    // the rank of the requested value (rounded up)
+    unsigned long long rank = (count * p + 99) / 100;
+    unsigned long long seen = 0;
+
+    for (unsigned i = 0; i < buckets; ++i)
+    {
+	seen += histogram[i];
+
+	if (seen >= rank)
+	{
+	    unsigned long long ret = bucketHighest(i);
+	    // the bucket might be wider than the real maximum
+	    return ret > max ? max : ret;
+	}
+    }
+
+    return max;
+}
+
+void CallStats::record(const std::string &name, unsigned long long usec)
+{
+    Entry &entry = _stats[name];
+
+    entry.count++;
+    entry.total += usec;
+    if (usec > entry.max)
+	entry.max = usec;
+
+    entry.histogram[bucket(usec)]++;
+}
+
+void CallStats::reset()
+{
+    y2milestone("Resetting the builtin statistics (%zu builtins)", _stats.size());
+    _stats.clear();
+}
+
+YCPMap CallStats::asYCPMap() const
+{
+    YCPMap ret;
+
+    for (Stats::const_iterator it = _stats.begin(); it != _stats.end(); ++it)
+    {
+	const Entry &entry = it->second;
+	YCPMap values;
+
+	values->add(YCPString("count"), YCPInteger(entry.count));
+	values->add(YCPString("total"), YCPInteger(entry.total));
+	values->add(YCPString("max"), YCPInteger(entry.max));
+	values->add(YCPString("p50"), YCPInteger(entry.percentile(50)));
+	values->add(YCPString("p99"), YCPInteger(entry.percentile(99)));
+
+	ret->add(YCPString(it->first), values);
+    }
+
+    return ret;
+}
+
+bool CallStats::dump(const std::string &file) const
+{
+    FILE *f = ::fopen(file.c_str(), "w");
+
+    if (f == NULL)
+    {
+	y2error("Cannot write the builtin statistics to %s: %s", file.c_str(), ::strerror(errno));
+	return false;
+    }
+
+    y2milestone("Writing the builtin statistics to %s", file.c_str());
+
+    ::fprintf(f, "# builtin count total_us max_us p50_us p99_us\n");
+
+    for (Stats::const_iterator it = _stats.begin(); it != _stats.end(); ++it)
+    {
+	const Entry &entry = it->second;
+
+	::fprintf(f, "%s %llu %llu %llu %llu %llu\n", it->first.c_str(),
+	    entry.count, entry.total, entry.max, entry.percentile(50), entry.percentile(99));
+    }
+
+    return ::fclose(f) == 0;
+}
@@ -0,0 +1,106 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	CallStats.h
+   Summary:     Call count and timing statistics of the Pkg builtins
+*/
+
+#ifndef CallStats_h
+#define CallStats_h
+
+#include <map>
+#include <string>
+#include <chrono>
+
+#include <ycp/YCPMap.h>
+
+/**
+ * Collects per builtin statistics: number of calls, total and maximal
+ * wall time and a log-linear histogram for computing the percentiles.
+ *
+ * Note: the time of a builtin includes the time spent in the YCP callbacks
+ * evaluated from it (and in the nested Pkg calls made by these callbacks).
+ */
+class CallStats
+{
+    public:
+
+	/**
+	 * Measures the time of one builtin call, the result is recorded
+	 * in the destructor (i.e. also when the builtin throws an exception).
+	 */
+	class Timer
+	{
+	    public:
+		Timer(const std::string &name)
+		    : _name(name), _start(std::chrono::steady_clock::now())
+		{}
+
+		~Timer();
+
+	    private:
+		const std::string &_name;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	static CallStats& instance();
+
+	// record a finished call, the time is in microseconds
+	void record(const std::string &name, unsigned long long usec);
+
+	// forget all collected data
+	void reset();
+
+	// builtin name -> $[ "count" : integer, "total" : integer, "max" : integer,
+	//   "p50" : integer, "p99" : integer ] (times in microseconds)
+	YCPMap asYCPMap() const;
+
+	// write the statistics to a file, returns false on error
+	bool dump(const std::string &file) const;
+
+    private:
+
+	CallStats() {}
+
+	// 8 linear sub-buckets per power of two, i.e. the relative error
+	// of a reported percentile is at most 12.5%
+	static const unsigned sub_bucket_bits = 3;
+	static const unsigned sub_buckets = 1 << sub_bucket_bits;
+	static const unsigned buckets = sub_buckets + (64 - sub_bucket_bits) * sub_buckets;
+
+	struct Entry
+	{
+	    Entry() : count(0), total(0), max(0), histogram() {}
+
+	    unsigned long long count;
+	    unsigned long long total;
+	    unsigned long long max;
+	    unsigned int histogram[buckets];
+
+	    // approximate percentile (0 < p <= 100)
+	    unsigned long long percentile(unsigned p) const;
+	};
+
+	static unsigned bucket(unsigned long long usec);
+	static unsigned long long bucketHighest(unsigned index);
+
+	typedef std::map<std::string, Entry> Stats;
+	Stats _stats;
+};
+
+#endif // CallStats_h
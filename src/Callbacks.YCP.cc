@@ -21,6 +21,7 @@
 /-*/
 
 #include "Callbacks.YCP.h"
+#include "ProcessPool.h"
 #include "log.h"
 
 #include <y2/Y2ComponentBroker.h>
@@ -126,6 +127,7 @@
         ENUM_OUT( FileConflictProgress );
         ENUM_OUT( FileConflictReport );
         ENUM_OUT( FileConflictFinish );
+        ENUM_OUT( EventBatch );
 #undef ENUM_OUT
 	// no default! let compiler warn missing values
       }
@@ -178,6 +180,10 @@
      * no need to create and evaluate it.
      **/
     bool PkgFunctions::CallbackHandler::YCPCallbacks::isSet( CBid id_r ) const {
+       // no user interaction in a forked child process
+       if ( ProcessPool::inChild() )
+	 return false;
+
        const _cbdata_t::const_iterator tmp1 = _cbdata.find(id_r);
        return tmp1 != _cbdata.end() && !tmp1->second.empty();
     }
@@ -186,6 +192,9 @@
      * @return The YCPCallback term, ready to append any arguments.
      **/
     Y2Function* PkgFunctions::CallbackHandler::YCPCallbacks::createCallback( CBid id_r ) const {
+	if ( ProcessPool::inChild() )
+	    return NULL;
+
 	const _cbdata_t::const_iterator tmp1 = _cbdata.find(id_r);
 
 	if (tmp1 == _cbdata.end())
@@ -226,22 +235,162 @@
     }
 
 
-bool PkgFunctions::CallbackHandler::YCPCallbacks::Send::CB::expecting( YCPValueType exp_r ) const
+bool PkgFunctions::CallbackHandler::YCPCallbacks::Send::CB::expecting( PlainValue::Kind exp_r ) const
 {
-    if ( _result->valuetype() == exp_r )
+    if ( _result.kind() == exp_r )
       return true;
-    y2internal ("Wrong return type %s: Expected %s", Type::vt2type(_result->valuetype())->toString().c_str(), Type::vt2type(exp_r)->toString().c_str());
+    y2internal ("Wrong return type %s: Expected %s", PlainValue::kindName(_result.kind()), PlainValue::kindName(exp_r));
     return false;
 }
 
+    bool PkgFunctions::CallbackHandler::YCPCallbacks::isProgress( CBid id_r ) {
+	switch ( id_r ) {
+	    case CB_ProgressRebuildDb:
+	    case CB_ProgressScanDb:
+	    case CB_ProgressProvide:
+	    case CB_ProgressPackage:
+	    case CB_SourceCreateProgress:
+	    case CB_ProgressProgress:
+	    case CB_ProgressSourceRefresh:
+	    case CB_ProgressDeltaDownload:
+	    case CB_ProgressDeltaApply:
+	    case CB_ProgressDownload:
+	    case CB_FileConflictProgress:
+	    case CB_SourceProbeProgress:
+	    case CB_SourceReportProgress:
+	    case CB_ScriptProgress:
+	    case CB_ProcessProgress:
+		return true;
+	    default:
+		return false;
+	}
+    }
+
+    bool PkgFunctions::CallbackHandler::YCPCallbacks::queueEvent( CBid id_r, const PlainValue &args_r ) const {
+	// batching is not used in async operations, this is the main thread
+	YCPMap event;
+	event->add( YCPString( "name" ), YCPString( cbName( id_r ) ) );
+	event->add( YCPString( "args" ), args_r.toYCP() );
+	_batch_events->add( event );
+
+	// the batch handler itself triggered the event, it is delivered in the next batch
+	if ( !_batch_flushing
+	    && std::chrono::steady_clock::now() - _batch_last_flush >= std::chrono::milliseconds( _batch_interval ) )
+	{
+	    flushEvents();
+	}
+
+	// deliver the abort request (possibly from an earlier flush) to the progress
+	return takeBatchContinue();
+    }
+
+    bool PkgFunctions::CallbackHandler::YCPCallbacks::flushEvents() const {
+	// the queue is used only in the main thread
+	if ( _batch_flushing || AsyncOperation::current() )
+	    return _batch_continue;
+
+	if ( _batch_events->isEmpty() )
+	    return _batch_continue;
+
+	_batch_last_flush = std::chrono::steady_clock::now();
+
+	YCPList events( _batch_events );
+	_batch_events = YCPList();
+
+	Y2Function *func = createCallback( CB_EventBatch );
+
+	if ( func == NULL )
+	{
+	    // the handler has been unregistered, drop the events
+	    y2warning( "Dropping %d queued callback events", events->size() );
+	    return _batch_continue;
+	}
+
+	y2debug( "Evaluating EventBatch callback (%d events)", events->size() );
+
+	_batch_flushing = true;
+	func->appendParameter( events );
+	YCPValue ret = func->evaluateCall();
+	_batch_flushing = false;
+
+	delete func;
+
+	if ( !ret.isNull() && ret->isBoolean() )
+	    _batch_continue = ret->asBoolean()->value();
+	else
+	    y2error( "EventBatch callback evaluated to a non-boolean value: %s",
+		ret.isNull() ? "nil" : ret->toString().c_str() );
+
+	if ( !_batch_continue )
+	    y2milestone( "EventBatch callback requested abort" );
+
+	return _batch_continue;
+    }
+
+    bool PkgFunctions::CallbackHandler::YCPCallbacks::takeBatchContinue() const {
+	bool ret = _batch_continue;
+	// the abort is being delivered, the next events are handled normally
+	_batch_continue = true;
+	return ret;
+    }
+
+
+    PlainValue PkgFunctions::CallbackHandler::YCPCallbacks::call( CBid id_r, const PlainValue &args_r ) const {
+	PlainValue ret;
+
+	// the YCP values are created, evaluated and destroyed here
+	std::function<void ()> evaluate = [this, id_r, &args_r, &ret] {
+	    Y2Function *func = createCallback( id_r );
+
+	    if ( func == NULL )
+		return;
+
+	    for ( PlainValue::Items::const_iterator it = args_r.items().begin(); it != args_r.items().end(); ++it )
+		func->appendParameter( it->toYCP() );
+
+	    ret = PlainValue::fromYCP( func->evaluateCall() );
+	    delete func;
+	};
+
+	AsyncOperation *op = AsyncOperation::current();
+
+	if ( op )
+	{
+	    y2debug( "Passing callback %s to the main thread", cbName( id_r ).c_str() );
+	    op->callOnMain( evaluate );
+	}
+	else
+	{
+	    evaluate();
+	}
+
+	return ret;
+    }
+
+
 bool PkgFunctions::CallbackHandler::YCPCallbacks::Send::CB::evaluate()
 {
-    if ( _set && _func ) {
-      y2debug ("Evaluating callback (registered funciton: %s)", _func->name().c_str());
-      _result = _func->evaluateCall ();
+    if ( _async ) {
+      std::vector<long long> values;
+      for ( PlainValue::Items::const_iterator it = _args.items().begin(); it != _args.items().end(); ++it )
+	if ( it->kind() == PlainValue::Integer ) values.push_back( it->asInteger() );
+
+      _result = PlainValue::boolean( _async->progress( cbName( _id ), values ) );
+      return true;
+    }
+
+    if ( _batched ) {
+      _result = PlainValue::boolean( _send.ycpcb().queueEvent( _id, _args ) );
+      return true;
+    }
+
+    // deliver the pending progress before any other event
+    if ( _send.ycpcb().isSet( CB_EventBatch ) )
+      _send.ycpcb().flushEvents();
 
-      delete _func;
-      _func = _send.ycpcb().createCallback( _id );
+    if ( _set ) {
+      y2debug ("Evaluating callback %s", cbName( _id ).c_str());
+      _result = _send.ycpcb().call( _id, _args );
       return true;
     }
 
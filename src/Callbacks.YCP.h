@@ -23,6 +23,7 @@
 #define PkgModuleCallbacksYCP_h
 
 #include <stack>
+#include <chrono>
 
 #include <y2util/stringutil.h>
 //#include <y2util/Date.h>
@@ -33,6 +34,8 @@
 
 #include "ycpTools.h"
 #include "Callbacks.h"
+#include "AsyncOperation.h"
+#include "PlainValue.h"
 
 //#include <ycp/y2log.h>
 
@@ -49,10 +52,10 @@ using namespace std;
  *
  * To invoke a YCPCallback:
  * <PRE>
- *   YCPTerm callback = createCallback( CB_PatchProgress ); // create callback Term
- *   callback->add( YCPInteger ( percent ) );               // add arguments
- *   callback->add( YCPString ( pkg ) );
- *   bool result = evaluateBool( callback );                // evaluate
+ *   PlainValue args( PlainValue::list() );                 // create the arguments
+ *   args.add( PlainValue::integer( percent ) );
+ *   args.add( PlainValue::string( pkg ) );
+ *   PlainValue result = call( CB_PatchProgress, args );    // evaluate
  * </PRE>
  **/
 class PkgFunctions::CallbackHandler::YCPCallbacks
@@ -107,6 +110,8 @@ class PkgFunctions::CallbackHandler::YCPCallbacks
       CB_ProcessNextStage,
       CB_ProcessProgress,
       CB_ProcessFinished,
+
+      CB_EventBatch,
     };
 
     /**
@@ -120,12 +125,25 @@ class PkgFunctions::CallbackHandler::YCPCallbacks
     typedef map <CBid, stack<YCPReference> > _cbdata_t;
     _cbdata_t _cbdata;
 
+    // the queued progress events (batch mode), modified by the const
+    // senders so they are mutable
+    mutable YCPList _batch_events;
+    mutable std::chrono::steady_clock::time_point _batch_last_flush;
+    // the result of the last batch handler call (false = abort)
+    mutable bool _batch_continue;
+    // reentrancy guard, the batch handler might call a Pkg builtin
+    mutable bool _batch_flushing;
+    long long _batch_interval;
+
   public:
 
     /**
      * Constructor.
      **/
     YCPCallbacks( )
+      : _batch_continue( true )
+      , _batch_flushing( false )
+      , _batch_interval( 250 )
     {}
 
 
@@ -150,11 +168,63 @@ class PkgFunctions::CallbackHandler::YCPCallbacks
 
   public:
 
+  private:
+
     /**
      * @return The YCPCallback term, ready to append any arguments.
+     * Call it only in the main thread.
      **/
     Y2Function* createCallback( CBid id_r ) const;
 
+  public:
+
+    /**
+     * @return Whether the callback is a progress callback
+     * which is delivered via the EventBatch callback if it is set.
+     **/
+    static bool isProgress( CBid id_r );
+
+    /**
+     * @return Whether the callback is queued and delivered in a batch.
+     **/
+    bool isBatched( CBid id_r ) const
+    { return isProgress( id_r ) && isSet( CB_EventBatch ); }
+
+    /**
+     * Queue a progress event, the queue is flushed when the batch
+     * interval has elapsed.
+     * @return false if the batch handler requested abort
+     **/
+    bool queueEvent( CBid id_r, const PlainValue &args_r ) const;
+
+    /**
+     * Deliver the queued events to the EventBatch callback.
+     * @return false if the batch handler requested abort (the request
+     * is kept until it is delivered via takeBatchContinue())
+     **/
+    bool flushEvents() const;
+
+    /**
+     * @return false if the batch handler requested abort, the request
+     * is reset (it has been delivered to the caller)
+     **/
+    bool takeBatchContinue() const;
+
+    /**
+     * Set the batch flush interval (in milliseconds).
+     **/
+    void setBatchInterval( long long interval_r ) { _batch_interval = interval_r; }
+
+    /**
+     * Evaluate a callback, all YCP callbacks must be evaluated via this function.
+     * In an async operation the whole evaluation (creating the function call,
+     * converting the arguments and the result) is done in the main thread
+     * (see AsyncOperation), the YCP values must not be used in the worker thread.
+     * @param args_r list of the arguments
+     * @return the result, nil if the callback is not set
+     **/
+    PlainValue call( CBid id_r, const PlainValue &args_r = PlainValue::list() ) const;
+
   public:
 
     /**
@@ -176,66 +246,74 @@ class PkgFunctions::CallbackHandler::YCPCallbacks
 	struct CB {
 	  const Send & _send;
 	  CBid _id;
+	  // a progress event in an async operation, it is not evaluated,
+	  // only the values are passed to the operation
+	  AsyncOperation* _async;
+	  // queue the event instead of evaluating the callback (batch mode)
+	  bool     _batched;
 	  bool     _set;
-	  Y2Function* _func;
-	  YCPValue _result;
+	  // the arguments and the result, the YCP values are created
+	  // only when evaluating the callback in the main thread
+	  PlainValue _args;
+	  PlainValue _result;
 	  CB( const Send & send_r, CBid func )
 	    : _send( send_r )
 	    , _id( func )
-	    , _set( _send.ycpcb().isSet( func ) )
-	    , _func( _send.ycpcb().createCallback( func ) )
-	    , _result( YCPVoid() )
+	    , _async( isProgress( func ) ? AsyncOperation::current() : NULL )
+	    , _batched( !_async && _send.ycpcb().isBatched( func ) )
+	    , _set( _async || _batched || _send.ycpcb().isSet( func ) )
+	    , _args( PlainValue::list() )
 	  {}
 
-	  ~CB ()
-	  {
-	    if (_func) delete _func;
+	  CB & add( const PlainValue & arg ) {
+	    if (_set) _args.add( arg );
+	    return *this;
 	  }
 
-	  CB & addStr( const string & arg ) { if (_func != NULL) _func->appendParameter( YCPString( arg ) ); return *this; }
+	  CB & addStr( const string & arg ) { return add( PlainValue::string( arg ) ); }
 	  CB & addStr( const zypp::Pathname & arg ) { return addStr( arg.asString() ); }
 	  CB & addStr( const zypp::Url & arg ) { return addStr( arg.asString() ); }
 
-	  CB & addInt( long long arg ) { if (_func != NULL) _func->appendParameter( YCPInteger( arg ) ); return *this; }
+	  CB & addInt( long long arg ) { return add( PlainValue::integer( arg ) ); }
 
-	  CB & addBool( bool arg ) { if (_func != NULL) _func->appendParameter( YCPBoolean( arg ) ); return *this; }
+	  CB & addBool( bool arg ) { return add( PlainValue::boolean( arg ) ); }
 
-	  CB & addMap( YCPMap arg ) { if (_func != NULL) _func->appendParameter( arg ); return *this; }
-	  CB & addList( YCPList arg ) { if (_func != NULL) _func->appendParameter( arg ); return *this; }
+	  CB & addMap( const PlainValue & arg ) { return add( arg ); }
+	  CB & addList( const PlainValue & arg ) { return add( arg ); }
 
-	  CB & addSymbol( const string &arg ) { if (_func != NULL) _func->appendParameter( YCPSymbol(arg) ); return *this; }
+	  CB & addSymbol( const string &arg ) { return add( PlainValue::symbol( arg ) ); }
 
-	  bool isStr() const { return _result->isString(); }
-	  bool isInt() const { return _result->isInteger(); }
-	  bool isBool() const { return _result->isBoolean(); }
+	  bool isStr() const { return _result.kind() == PlainValue::String; }
+	  bool isInt() const { return _result.kind() == PlainValue::Integer; }
+	  bool isBool() const { return _result.kind() == PlainValue::Boolean; }
 
-	  bool expecting( YCPValueType exp_r ) const;
+	  bool expecting( PlainValue::Kind exp_r ) const;
 
 	  bool evaluate();
 
-	  bool evaluate( YCPValueType exp_r ) {
+	  bool evaluate( PlainValue::Kind exp_r ) {
 	    return evaluate() && expecting( exp_r );
 	  }
 
 	  string evaluateStr( const string & def_r = "" ) {
-	    return evaluate( YT_STRING ) ? _result->asString()->value() : def_r;
+	    return evaluate( PlainValue::String ) ? _result.asString() : def_r;
 	  }
 
 	  string evaluateSymbol( const string & def_r = "" ) {
-	    return evaluate( YT_SYMBOL ) ? _result->asSymbol()->symbol() : def_r;
+	    return evaluate( PlainValue::Symbol ) ? _result.asString() : def_r;
 	  }
 
 	  long long evaluateInt( const long long & def_r = 0 ) {
-	    return evaluate( YT_INTEGER ) ? _result->asInteger()->value() : def_r;
+	    return evaluate( PlainValue::Integer ) ? _result.asInteger() : def_r;
 	  }
 
 	  bool evaluateBool( const bool & def_r = false ) {
-	    return evaluate( YT_BOOLEAN ) ? _result->asBoolean()->value() : def_r;
+	    return evaluate( PlainValue::Boolean ) ? _result.asBoolean() : def_r;
 	  }
 
-	  YCPMap evaluateMap( const YCPMap def_r = YCPMap())
+	  PlainValue evaluateMap( const PlainValue def_r = PlainValue::map() )
 	  {
-	      return evaluate( YT_MAP ) ? _result->asMap() : def_r;
+	      return evaluate( PlainValue::Map ) ? _result : def_r;
 	  }
 	};
       private:
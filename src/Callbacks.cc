@@ -178,6 +178,9 @@ namespace ZyppRecipients {
 	  if( _last == resolvable )
 	    return;
 
+	  // download the next packages meanwhile
+	  _pkg_ref.CommitInstalling(resolvable->satSolvable());
+
 	  // convert the repo ID
 	  PkgFunctions::RepoId source_id = _pkg_ref.logFindAlias(res->repoInfo().alias());
 	  int media_nr = res->mediaNr();
@@ -281,6 +284,9 @@ namespace ZyppRecipients {
                 // return value ignored
                 callback.evaluateStr();
             }
+
+	    // the next package is going to be downloaded
+	    _pkg_ref.CommitInstalled(resolvable->satSolvable());
 	}
     };
 
@@ -446,6 +452,9 @@ namespace ZyppRecipients {
 	int last_reported_patch_download;
 	time_t last_reported_patch_download_time;
 
+	// the repository of the current package (for the download statistics)
+	std::string _alias;
+
 	virtual void reportbegin()
 	{
 	}
@@ -459,6 +468,7 @@ namespace ZyppRecipients {
 	  unsigned size = 0;
 	  last_reported = 0;
 	  last_reported_time = time(NULL);
+	  _alias.clear();
 
 	  if ( zypp::isKind<zypp::Package> (resolvable_ptr) )
 	  {
@@ -467,6 +477,10 @@ namespace ZyppRecipients {
 
 	    size = pkg->downloadSize();
 
+	    // count the following file downloads for the package repository
+	    _alias = pkg->repoInfo().alias();
+	    _pkg_ref.transferStats().setRepository(_alias);
+
 	    // convert the repo ID
 	    PkgFunctions::RepoId source_id = _pkg_ref.logFindAlias(pkg->repoInfo().alias());
 	    int media_nr = pkg->mediaNr();
@@ -498,6 +512,9 @@ namespace ZyppRecipients {
 
 	virtual void finish(zypp::Resolvable::constPtr resolvable, zypp::repo::DownloadResolvableReport::Error error, const std::string &reason)
 	{
+	    // the failures are counted per file in DownloadProgressReceive
+	    _pkg_ref.transferStats().setRepository("");
+
 	    CB callback( ycpcb( YCPCallbacks::CB_DoneProvide) );
 	    if (callback._set) {
 		callback.addInt( error );
@@ -674,7 +691,7 @@ namespace ZyppRecipients {
     {
       typedef zypp::target::rpm::RpmDb RpmDb;
       CB callback( ycpcb( YCPCallbacks::CB_PkgGpgCheck ) );
-      YCPMap data;
+      PlainValue data(PlainValue::map());
 
       if (callback._set) {
         // Package or SrcPackage (ResObject is common base class)
@@ -683,20 +700,19 @@ namespace ZyppRecipients {
 	  resobject_r = userData_r.get<zypp::ResObject::constPtr>( "ResObject" );
 	else // legacy callback sending "zypp::Package::constPtr "Package"
 	  resobject_r = userData_r.get<zypp::Package::constPtr>("Package");
-        YCPString package = resobject_r->name();
-        data->add(YCPString("Package"), package);
+        data.add("Package", PlainValue::string(resobject_r->name()));
 
         const zypp::RepoInfo repo = resobject_r->repoInfo();
         const std::string url = repo.rawUrl().asString();
-        data->add(YCPString("RepoMediaUrl"), YCPString(url));
+        data.add("RepoMediaUrl", PlainValue::string(url));
 
         // Localpath
         zypp::Pathname localpath = userData_r.get<zypp::Pathname>("Localpath");
-        data->add(YCPString("Localpath"), YCPString(localpath.asString()));
+        data.add("Localpath", PlainValue::string(localpath.asString()));
 
         // Result
-        YCPInteger checkPackageResult = userData_r.get<RpmDb::CheckPackageResult>("CheckPackageResult");
-        data->add(YCPString("CheckPackageResult"), checkPackageResult);
+        RpmDb::CheckPackageResult checkPackageResult = userData_r.get<RpmDb::CheckPackageResult>("CheckPackageResult");
+        data.add("CheckPackageResult", PlainValue::integer(checkPackageResult));
 
         callback.addMap(data);
 
@@ -724,13 +740,18 @@ namespace ZyppRecipients {
     {
 	int last_reported;
 	time_t last_reported_time;
+	PkgFunctions &_pkg_ref;
 
-	DownloadProgressReceive( RecipientCtl & construct_r ) : Recipient( construct_r ) {}
+	DownloadProgressReceive( RecipientCtl & construct_r, PkgFunctions &pk ) : Recipient( construct_r ), _pkg_ref(pk) {}
 
         virtual void start( const zypp::Url &file, zypp::Pathname localfile )
 	{
 	    last_reported = 0;
 	    last_reported_time = time(NULL);
+
+	    // a package download or find the repository by the URL
+	    std::string alias(_pkg_ref.transferStats().repository());
+	    _pkg_ref.transferStats().start(file, localfile, alias.empty() ? _pkg_ref.AliasForUrl(file) : alias);
 	    CB callback( ycpcb( YCPCallbacks::CB_StartDownload ) );
 
 	    if ( callback._set )
@@ -743,6 +764,8 @@ namespace ZyppRecipients {
 
         virtual bool progress(int value, const zypp::Url &file, double bps_avg, double bps_current)
         {
+	    _pkg_ref.transferStats().progress(bps_current);
+
 	    CB callback( ycpcb( YCPCallbacks::CB_ProgressDownload ) );
 	    // call the callback function only if the difference since the last call is at least 5%
 	    // or if 100% is reached or if at least 3 seconds have elapsed
@@ -774,7 +797,11 @@ namespace ZyppRecipients {
 		y2milestone("DoneProvide result: %s", ret.c_str());
 
                 // "R" =  retry
-                if (ret == "R") return zypp::media::DownloadProgressReport::RETRY;
+                if (ret == "R")
+                {
+                    _pkg_ref.transferStats().retry();
+                    return zypp::media::DownloadProgressReport::RETRY;
+                }
 
                 // "C" = cancel
                 if (ret == "C") return zypp::media::DownloadProgressReport::ABORT;
@@ -800,6 +827,8 @@ namespace ZyppRecipients {
 		err = zypp::media::DownloadProgressReport::NO_ERROR;
 	    }
 
+	    _pkg_ref.transferStats().finish(err != zypp::media::DownloadProgressReport::NO_ERROR);
+
 	    if ( callback._set ) {
 		callback.addInt( err );
 		callback.addStr( reason );
@@ -925,24 +954,24 @@ namespace ZyppRecipients {
 		callback.addStr(auth_data.username());
 		callback.addStr(auth_data.password());
 
-		YCPMap cbk(callback.evaluateMap());
+		PlainValue cbk(callback.evaluateMap());
 
-		YCPValue ycp_val = cbk->value(YCPString("username"));
-		if (!ycp_val.isNull() && ycp_val->isString())
+		PlainValue val = cbk.value("username");
+		if (val.kind() == PlainValue::String)
 		{
 		    // set the entered username
-		    auth_data.setUsername(ycp_val->asString()->value());
+		    auth_data.setUsername(val.asString());
 		}
 		else
 		{
 		    y2error("Invalid/missing value 'username'");
 		}
 
-		ycp_val = cbk->value(YCPString("password"));
-		if (!ycp_val.isNull() && ycp_val->isString())
+		val = cbk.value("password");
+		if (val.kind() == PlainValue::String)
 		{
 		    // set the entered password
-		    auth_data.setPassword(ycp_val->asString()->value());
+		    auth_data.setPassword(val.asString());
 		}
 		else
 		{
@@ -952,11 +981,11 @@ namespace ZyppRecipients {
 		// authentication confirmed?
 		bool ret = false;
 
-		ycp_val = cbk->value(YCPString("continue"));
-		if (!ycp_val.isNull() && ycp_val->isBoolean())
+		val = cbk.value("continue");
+		if (val.kind() == PlainValue::Boolean)
 		{
 		    // continue?
-		    ret = ycp_val->asBoolean()->value();
+		    ret = val.asBoolean();
 		    y2milestone("Use the authentication data: %s", ret ? "true" : "false");
 		}
 		else
@@ -1072,10 +1101,10 @@ namespace ZyppRecipients {
 		callback.addBool( false );
 
 		// add device names
-		YCPList device_names;
+		PlainValue device_names(PlainValue::list());
 	        for_(iter, devices.begin(), devices.end())
 		{
-		    device_names->add(YCPString(*iter));
+		    device_names.add(PlainValue::string(*iter));
 		}
 		callback.addList(device_names);
 
@@ -1580,7 +1609,7 @@ namespace ZyppRecipients {
 	    {
 		GPGMap gpgmap(key);
 
-		callback.addMap(gpgmap.getMap());
+		callback.addMap(gpgmap.getValue());
 		PkgFunctions::RepoId srcid = context.empty() ? _pkg_ref.current_repo_id() : _pkg_ref.logFindAlias(context.repoInfo().alias());
 		callback.addInt(srcid);
 
@@ -1642,7 +1671,7 @@ namespace ZyppRecipients {
 		GPGMap gpgmap(key);
 
 		callback.addStr(file);
-		callback.addMap(gpgmap.getMap());
+		callback.addMap(gpgmap.getValue());
 		long long srcid = _pkg_ref.logFindAlias(context.repoInfo().alias());
 		callback.addInt(srcid);
 
@@ -1668,7 +1697,7 @@ namespace ZyppRecipients {
 	    {
 		GPGMap gpgmap(key);
 
-		callback.addMap(gpgmap.getMap());
+		callback.addMap(gpgmap.getValue());
 		callback.evaluate();
 	    }
 	}
@@ -1681,7 +1710,7 @@ namespace ZyppRecipients {
 	    {
 		GPGMap gpgmap(key);
 
-		callback.addMap(gpgmap.getMap());
+		callback.addMap(gpgmap.getValue());
 		callback.evaluate();
 	    }
 	}
@@ -1728,21 +1757,21 @@ namespace ZyppRecipients {
                 return true;
             }
 
-            YCPList excluded_packages;
+            PlainValue excluded_packages(PlainValue::list());
             for_(iter, noFilelist_r.begin(), noFilelist_r.end())
             {
                 // convert solvable ID to a Package
                 zypp::Package::Ptr pkg(zypp::make<zypp::Package>(zypp::sat::Solvable(*iter)));
                 if (pkg) {
-                    excluded_packages->add(YCPString(pkg->name() + "-" +
+                    excluded_packages.add(PlainValue::string(pkg->name() + "-" +
                     pkg->edition().asString() + "-" + pkg->arch().asString()));
                 }
             }
 
-            YCPList conflicts;
+            PlainValue conflicts(PlainValue::list());
             for_(iter, conflicts_r.begin(), conflicts_r.end())
             {
-                conflicts->add(YCPString(iter->asUserString()));
+                conflicts.add(PlainValue::string(iter->asUserString()));
             }
 
             callback.addList(excluded_packages);
@@ -1839,7 +1868,7 @@ class PkgFunctions::CallbackHandler::ZyppReceive : public ZyppRecipients::Recipi
       , _providePkgReceive( *this, pkg )
       , _fileConflictReceive( *this )
       , _mediaChangeReceive( *this )
-      , _downloadProgressReceive( *this )
+      , _downloadProgressReceive( *this, pkg )
       , _scriptExecReceive( *this )
       , _messageReceive( *this )
       , _sourceCreateReceive( *this )
@@ -729,5 +729,63 @@ YCPValue PkgFunctions::CallbackFileConflictFinish( const YCPValue& args )
     return SET_YCP_CB( CB_FileConflictFinish, args);
 }
 
+/**
+ * @builtin CallbackEventBatch
+ * @short Register a callback function
+ * @description
+ * Enables the batch mode for the progress callbacks. The progress events
+ * (ProgressDownload, ProgressPackage, ProgressProvide, ProcessProgress, ProgressProgress, ...)
+ * are not delivered to the separate callbacks but they are queued and delivered
+ * together to this callback after the batch interval (see SetCallbackEventBatchInterval),
+ * before any other (non progress) callback and at the end of the builtin call.
+ *
+ * The events are delivered even if the respective progress callback is not registered.
+ *
+ * @param string args Name of the callback handler function. Required callback
+ * prototype is <code>boolean(list&lt;map&lt;string,any&gt;&gt; events)</code>,
+ * each event is a map <code>$[ "name" : "ProgressDownload", "args" : [ 42, 1024, 2048 ] ]</code>
+ * where "name" is the name of the progress callback (without the "Callback" prefix)
+ * and "args" are its arguments. The returned boolean indicates whether to continue (true) or abort (false),
+ * the result is used for all progress events until the next batch is delivered.
+ * @return void
+ */
+YCPValue PkgFunctions::CallbackEventBatch( const YCPValue& args )
+{
+    // deliver the events queued for the previous handler
+    _callbackHandler._ycpCallbacks.flushEvents();
+    return SET_YCP_CB( CB_EventBatch, args);
+}
+
+/**
+ * @builtin SetCallbackEventBatchInterval
+ * @short Set the interval of the batched progress events
+ * @param integer interval The interval in milliseconds (default 250)
+ * @return void
+ */
+YCPValue PkgFunctions::SetCallbackEventBatchInterval( const YCPInteger& interval )
+{
+    long long value = interval->value();
+
+    if (value < 0)
+    {
+	y2error("Invalid interval: %lld", value);
+	return YCPVoid();
+    }
+
+    y2milestone("Setting the callback event batch interval to %lldms", value);
+    _callbackHandler._ycpCallbacks.setBatchInterval(value);
+
+    return YCPVoid();
+}
+
+void PkgFunctions::FlushCallbackEvents()
+{
+    _callbackHandler._ycpCallbacks.flushEvents();
+
+    // the outermost builtin has finished, there is nothing to abort anymore,
+    // do not abort the next operation
+    if (!_callbackHandler._ycpCallbacks.takeBatchContinue())
+	y2milestone("Ignoring the abort request, the operation has finished");
+}
 
 #undef SET_YCP_CB
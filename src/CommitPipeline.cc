@@ -0,0 +1,278 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	CommitPipeline.cc
+   Summary:     Downloading the packages while installing the previous ones
+*/
+
+#include "CommitPipeline.h"
+#include "ProcessPool.h"
+#include "log.h"
+
+#include <zypp/base/Easy.h>
+#include <zypp/sat/Transaction.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+
+bool prefetchPackage(const zypp::Package::constPtr &package, zypp::repo::RepoMediaAccess &access)
+{
+    try
+    {
+	zypp::repo::PackageProviderPolicy policy;
+	zypp::repo::DeltaCandidates deltas;
+	zypp::repo::PackageProvider provider(access, package, deltas, policy);
+
+	zypp::ManagedFile file(provider.providePackage());
+	// keep the file in the cache
+	file.resetDispose();
+    }
+    catch (const zypp::Exception &e)
+    {
+	y2error("Cannot download %s: %s", package->name().c_str(), e.asString().c_str());
+	return false;
+    }
+
+    return true;
+}
+
+CommitPipeline::CommitPipeline(unsigned depth)
+    // the first package is downloaded by Commit() right away
+    : _depth(depth), _requested(1), _socket(-1), _stop(-1)
+{
+    zypp::sat::Transaction transaction(zypp::sat::Transaction::loadFromPool);
+    transaction.order();
+
+    for_(step, transaction.actionBegin(), transaction.actionEnd())
+    {
+	if (step->stepType() == zypp::sat::Transaction::TRANSACTION_ERASE || !step->satSolvable().isKind<zypp::Package>())
+	    continue;
+
+	_positions[step->satSolvable().id()] = _packages.size();
+	_packages.push_back(zypp::make<zypp::Package>(step->satSolvable()));
+    }
+
+    y2milestone("Commit pipeline: %zu packages to install, depth %u", _packages.size(), _depth);
+
+    if (_packages.size() < 2 || _depth == 0)
+	return;
+
+    int sockets[2];
+
+    // SEQPACKET: each index is received by exactly one process
+    if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0)
+    {
+	y2error("Cannot create socket: %s", ::strerror(errno));
+	return;
+    }
+
+    int stop_pipe[2];
+
+    if (::pipe2(stop_pipe, O_CLOEXEC) != 0)
+    {
+	y2error("Cannot create pipe: %s", ::strerror(errno));
+	::close(sockets[0]);
+	::close(sockets[1]);
+	return;
+    }
+
+    _socket = sockets[0];
+    _stop = stop_pipe[1];
+    int child_socket = sockets[1];
+    int child_stop = stop_pipe[0];
+
+    for (unsigned i = 0; i < _depth; ++i)
+    {
+	pid_t pid = ProcessPool::spawn("commit pipeline", [this, child_socket, child_stop] {
+	    // close the parent's ends, the download ends when the parent closes them
+	    ::close(_socket);
+	    ::close(_stop);
+	    return downloadRequested(child_socket, child_stop);
+	});
+
+	if (pid > 0)
+	    _jobs.push_back(pid);
+    }
+
+    ::close(child_socket);
+    ::close(child_stop);
+
+    if (_jobs.empty())
+    {
+	stop();
+	return;
+    }
+
+    request(1 + _depth);
+}
+
+CommitPipeline::~CommitPipeline()
+{
+    stop();
+
+    for (std::vector<pid_t>::const_iterator it = _jobs.begin(); it != _jobs.end(); ++it)
+	ProcessPool::wait(*it);
+}
+
+void CommitPipeline::stop()
+{
+    // closing the pipe stops the processes even if there are queued requests
+    if (_stop >= 0)
+    {
+	::close(_stop);
+	_stop = -1;
+    }
+
+    if (_socket >= 0)
+    {
+	::close(_socket);
+	_socket = -1;
+    }
+
+    _pending.clear();
+}
+
+void CommitPipeline::installing(const zypp::sat::Solvable &solvable)
+{
+    std::map<zypp::sat::detail::SolvableIdType, size_t>::const_iterator it = _positions.find(solvable.id());
+
+    if (it == _positions.end())
+	return;
+
+    // download the next <depth> packages
+    request(it->second + 1 + _depth);
+}
+
+void CommitPipeline::installed(const zypp::sat::Solvable &solvable)
+{
+    std::map<zypp::sat::detail::SolvableIdType, size_t>::const_iterator it = _positions.find(solvable.id());
+
+    if (it == _positions.end())
+	return;
+
+    // do not download the next package twice
+    waitFor(it->second + 1);
+}
+
+void CommitPipeline::request(size_t limit)
+{
+    if (_socket < 0)
+	return;
+
+    while (_requested < limit && _requested < _packages.size())
+    {
+	size_t index = _requested++;
+
+	// already downloaded or in a local repository
+	if (_packages[index]->isCached() || !_packages[index]->repoInfo().url().schemeIsDownloading())
+	    continue;
+
+	if (::send(_socket, &index, sizeof(index), MSG_NOSIGNAL) != sizeof(index))
+	{
+	    y2error("Commit pipeline stopped: %s", ::strerror(errno));
+	    stop();
+	    return;
+	}
+
+	_pending.insert(index);
+	y2debug("Commit pipeline: requested %s", _packages[index]->name().c_str());
+    }
+}
+
+void CommitPipeline::waitFor(size_t index)
+{
+    if (_pending.find(index) == _pending.end())
+	return;
+
+    y2milestone("Commit pipeline: waiting for %s", _packages[index]->name().c_str());
+
+    while (_socket >= 0 && _pending.find(index) != _pending.end())
+    {
+	size_t done;
+	ssize_t size = ::recv(_socket, &done, sizeof(done), 0);
+
+	if (size < 0 && errno == EINTR)
+	    continue;
+
+	// all processes have finished (crashed?), Commit() downloads the rest itself
+	if (size <= 0)
+	{
+	    y2error("Commit pipeline stopped: %s", size < 0 ? ::strerror(errno) : "no download process");
+	    stop();
+	    return;
+	}
+
+	if (size == sizeof(done))
+	    _pending.erase(done);
+    }
+}
+
+bool CommitPipeline::downloadRequested(int fd, int stop_fd) const
+{
+    zypp::repo::RepoMediaAccess access;
+    bool ret = true;
+
+    while (true)
+    {
+	struct pollfd fds[2] = { { fd, POLLIN, 0 }, { stop_fd, POLLIN, 0 } };
+
+	if (::poll(fds, 2, -1) < 0)
+	{
+	    if (errno == EINTR)
+		continue;
+
+	    y2error("Commit pipeline: %s", ::strerror(errno));
+	    return false;
+	}
+
+	// the commit has finished, drop the queued requests
+	if (fds[1].revents)
+	    return ret;
+
+	size_t index;
+	ssize_t size = ::recv(fd, &index, sizeof(index), MSG_DONTWAIT);
+
+	if (size == 0)
+	    return ret;
+
+	if (size < 0)
+	{
+	    // received by another process
+	    if (errno == EINTR || errno == EAGAIN)
+		continue;
+
+	    y2error("Commit pipeline: %s", ::strerror(errno));
+	    return false;
+	}
+
+	if (size != sizeof(index) || index >= _packages.size())
+	    continue;
+
+	if (!prefetchPackage(_packages[index], access))
+	    ret = false;
+
+	// report it as done even on failure, Commit() downloads it then
+	if (::send(fd, &index, sizeof(index), MSG_NOSIGNAL) != sizeof(index))
+	    return ret;
+    }
+}
@@ -0,0 +1,107 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	CommitPipeline.h
+   Summary:     Downloading the packages while installing the previous ones
+*/
+
+#ifndef CommitPipeline_h
+#define CommitPipeline_h
+
+#include <vector>
+#include <map>
+#include <set>
+
+#include <sys/types.h>
+
+#include <zypp/Package.h>
+#include <zypp/repo/PackageProvider.h>
+
+/**
+ * Download a package into the package cache and keep it there
+ * (Commit() removes it after installing if "keeppackages" is off).
+ * @return true on success
+ */
+bool prefetchPackage(const zypp::Package::constPtr &package, zypp::repo::RepoMediaAccess &access);
+
+/**
+ * Downloads the next packages in the transaction order while Commit()
+ * is installing the current package, Commit() finds them in the package cache.
+ *
+ * The downloads run in forked processes (libzypp is not thread safe),
+ * the processes get the package indexes via a socket, at most "depth"
+ * packages after the currently installed package are requested.
+ * The processes send the index back when the download is done, Commit()
+ * waits for a running download instead of downloading the package again.
+ * The first package is downloaded by Commit() itself.
+ */
+class CommitPipeline
+{
+    public:
+
+	// start the download processes, request the first "depth" packages
+	CommitPipeline(unsigned depth);
+
+	// stop the download processes (after the current download is finished),
+	// the not yet started downloads are dropped
+	~CommitPipeline();
+
+	// a package installation has been started, request the next packages
+	void installing(const zypp::sat::Solvable &solvable);
+
+	// a package installation has been finished, Commit() is going to
+	// download the next package, wait if it is being downloaded
+	void installed(const zypp::sat::Solvable &solvable);
+
+    private:
+
+	// not copyable
+	CommitPipeline(const CommitPipeline&);
+	CommitPipeline& operator=(const CommitPipeline&);
+
+	// request the packages up to the index (excluding)
+	void request(size_t limit);
+
+	// wait until the requested package is downloaded
+	void waitFor(size_t index);
+
+	// stop using the download processes
+	void stop();
+
+	// download the requested packages (in the child process)
+	bool downloadRequested(int fd, int stop_fd) const;
+
+	unsigned _depth;
+
+	// the packages to install in the transaction order
+	std::vector<zypp::Package::constPtr> _packages;
+	// solvable ID -> index in _packages
+	std::map<zypp::sat::detail::SolvableIdType, size_t> _positions;
+	// the packages before this index have been requested
+	size_t _requested;
+	// requested, the download has not been reported as done yet
+	std::set<size_t> _pending;
+
+	// the parent's end of the socket (-1 if not started)
+	int _socket;
+	// closing it stops the download processes (-1 if not started)
+	int _stop;
+	std::vector<pid_t> _jobs;
+};
+
+#endif // CommitPipeline_h
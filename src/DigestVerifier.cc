@@ -0,0 +1,145 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	DigestVerifier.cc
+   Summary:     Verify the file checksums in parallel
+*/
+
+#include "DigestVerifier.h"
+
+#include <zypp/Digest.h>
+#include <zypp/base/String.h>
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+// the max. number of verifying threads
+static const unsigned max_verify_threads = 8;
+
+// zypp::Digest initializes OpenSSL on the first use and the initialization
+// is not thread safe, compute a digest in the calling (main) thread first
+static void initDigests()
+{
+    static bool initialized = false;
+
+    if (initialized)
+	return;
+
+    std::istringstream empty;
+    zypp::Digest::digest(zypp::Digest::sha256(), empty);
+    initialized = true;
+}
+
+DigestVerifier::DigestVerifier(unsigned threads)
+    : _threads(threads), _done(false)
+{
+    initDigests();
+
+    if (_threads == 0)
+	_threads = std::min(std::max(1u, std::thread::hardware_concurrency()), max_verify_threads);
+}
+
+DigestVerifier::~DigestVerifier()
+{
+    finish();
+}
+
+void DigestVerifier::add(const zypp::Pathname &file, const zypp::CheckSum &checksum, const std::string &name)
+{
+    Job job;
+    job.file = file;
+    job.checksum = checksum;
+    job.name = name;
+
+    {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_jobs.push_back(job);
+
+	// start the workers on demand
+	if (_workers.size() < _threads && _workers.size() < _jobs.size())
+	    _workers.push_back(std::thread(&DigestVerifier::worker, this));
+    }
+
+    _cond.notify_one();
+}
+
+std::map<std::string, std::string> DigestVerifier::finish()
+{
+    {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_done = true;
+    }
+
+    _cond.notify_all();
+
+    for (std::vector<std::thread>::iterator it = _workers.begin(); it != _workers.end(); ++it)
+	it->join();
+
+    _workers.clear();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _failed;
+}
+
+void DigestVerifier::worker()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true)
+    {
+	_cond.wait(lock, [this] { return _done || !_jobs.empty(); });
+
+	if (_jobs.empty())
+	    return;
+
+	Job job(_jobs.front());
+	_jobs.pop_front();
+
+	// compute the digest without the lock
+	lock.unlock();
+	std::string error(verify(job.file, job.checksum));
+	lock.lock();
+
+	if (!error.empty())
+	    _failed[job.name] = error;
+    }
+}
+
+std::string DigestVerifier::verify(const zypp::Pathname &path, const zypp::CheckSum &checksum)
+{
+    if (checksum.empty())
+	return "Missing checksum";
+
+    std::ifstream file(path.c_str(), std::ios::binary);
+
+    if (!file)
+	return "Cannot read the file";
+
+    std::string digest(zypp::Digest::digest(checksum.type(), file));
+
+    if (digest.empty())
+	return "Unsupported checksum type " + checksum.type();
+
+    std::string expected(zypp::str::toLower(checksum.checksum()));
+
+    if (digest != expected)
+	return "Checksum mismatch: expected " + expected + ", found " + digest;
+
+    return std::string();
+}
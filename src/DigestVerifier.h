@@ -0,0 +1,102 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	DigestVerifier.h
+   Summary:     Verify the file checksums in parallel
+*/
+
+#ifndef DigestVerifier_h
+#define DigestVerifier_h
+
+#include <map>
+#include <deque>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <zypp/Pathname.h>
+#include <zypp/CheckSum.h>
+
+/**
+ * Verifies the checksums of the files in worker threads while the caller
+ * is still downloading the next files. The digests are computed by libzypp
+ * (OpenSSL), it uses the CPU SHA extensions when available.
+ *
+ * The failures are collected and returned at the end, libzypp is not used
+ * in the worker threads except the digest computation (no logging, no callbacks),
+ * the lazy OpenSSL initialization is done by the constructor in the calling thread.
+ */
+class DigestVerifier
+{
+    public:
+
+	// threads = 0: use the number of CPUs
+	DigestVerifier(unsigned threads = 0);
+
+	// waits for the running verifications
+	~DigestVerifier();
+
+	/**
+	 * Add a file to verify.
+	 * @param file the local file
+	 * @param checksum the expected checksum (an empty checksum is reported as failure)
+	 * @param name the file name used in the result
+	 */
+	void add(const zypp::Pathname &file, const zypp::CheckSum &checksum, const std::string &name);
+
+	/**
+	 * Wait until all files are verified.
+	 * @return the failed files (name -> reason)
+	 */
+	std::map<std::string, std::string> finish();
+
+	/**
+	 * Verify a file synchronously.
+	 * @return the failure reason, empty on success
+	 */
+	static std::string verify(const zypp::Pathname &file, const zypp::CheckSum &checksum);
+
+    private:
+
+	// not copyable
+	DigestVerifier(const DigestVerifier&);
+	DigestVerifier& operator=(const DigestVerifier&);
+
+	struct Job
+	{
+	    zypp::Pathname file;
+	    zypp::CheckSum checksum;
+	    std::string name;
+	};
+
+	void worker();
+
+	unsigned _threads;
+	std::vector<std::thread> _workers;
+
+	std::mutex _mutex;
+	std::condition_variable _cond;
+	std::deque<Job> _jobs;
+	bool _done;
+
+	std::map<std::string, std::string> _failed;
+};
+
+#endif // DigestVerifier_h
@@ -0,0 +1,91 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+/*
+   File:	DiskUsage.cc
+   Summary:     The size of a directory tree (like "du")
+*/
+
+#include "DiskUsage.h"
+#include "log.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+
+bool walkFiles(const std::string &dir, const std::function<void(const std::string &, const struct stat &)> &fnc)
+{
+    DIR *d = ::opendir(dir.c_str());
+    if (!d)
+	return false;
+
+    bool ret = true;
+    struct dirent *entry;
+
+    while ((entry = ::readdir(d)) != NULL)
+    {
+	std::string name(entry->d_name);
+
+	if (name == "." || name == "..")
+	    continue;
+
+	struct stat st;
+	if (::fstatat(::dirfd(d), entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+	{
+	    ret = false;
+	    continue;
+	}
+
+	std::string path(dir + "/" + name);
+
+	if (S_ISDIR(st.st_mode))
+	{
+	    if (!walkFiles(path, fnc))
+		ret = false;
+	}
+	else if (S_ISREG(st.st_mode))
+	{
+	    fnc(path, st);
+	}
+    }
+
+    ::closedir(d);
+
+    return ret;
+}
+
+long long diskUsage(const std::string &dir, const InodeSet *skip)
+{
+    long long total = 0;
+    InodeSet seen;
+
+    bool read = walkFiles(dir, [&](const std::string &, const struct stat &st)
+    {
+	if (st.st_nlink > 1)
+	{
+	    std::pair<dev_t, ino_t> inode(st.st_dev, st.st_ino);
+
+	    if ((skip && skip->find(inode) != skip->end()) || !seen.insert(inode).second)
+		return;
+	}
+
+	total += st.st_size;
+    });
+
+    if (!read)
+	y2warning("Cannot read the size of %s", dir.c_str());
+
+    return total;
+}
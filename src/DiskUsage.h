@@ -0,0 +1,56 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+/*
+   File:	DiskUsage.h
+   Summary:     The size of a directory tree (like "du")
+*/
+
+#ifndef DiskUsage_h
+#define DiskUsage_h
+
+#include <set>
+#include <string>
+#include <utility>
+#include <functional>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// files identified by (device, inode)
+typedef std::set<std::pair<dev_t, ino_t> > InodeSet;
+
+/**
+ * Call the function for each regular file in the directory tree,
+ * the symlinks are not followed.
+ *
+ * @param dir the directory
+ * @param fnc the function called with the file path and its lstat() data
+ * @return false if a directory could not be read
+ */
+bool walkFiles(const std::string &dir, const std::function<void(const std::string &, const struct stat &)> &fnc);
+
+/**
+ * The total size of the regular files in the directory tree (like "du -b"),
+ * a file hardlinked several times in the tree is counted once.
+ *
+ * @param dir the directory
+ * @param skip the files which are not counted (e.g. hardlinks to a cache), can be NULL
+ * @return the size in bytes
+ */
+long long diskUsage(const std::string &dir, const InodeSet *skip = NULL);
+
+#endif // DiskUsage_h
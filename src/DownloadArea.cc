@@ -0,0 +1,238 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	DownloadArea.cc
+   Summary:     Size limited download area for the provided files
+*/
+
+#include "DownloadArea.h"
+#include "log.h"
+
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPString.h>
+
+#include <vector>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace
+{
+    // a cached file for evictCache()
+    struct CachedFile
+    {
+	std::string path;
+	long long used;
+	long long size;
+	std::pair<dev_t, ino_t> inode;
+    };
+}
+
+DownloadArea::DownloadArea()
+    : _uses(0), _limit(0), _usage(0), _cache_bytes(0), _peak(0), _evictions(0), _evicted_bytes(0)
+{
+}
+
+void DownloadArea::add(const zypp::filesystem::TmpDir &dir)
+{
+    // the files hardlinked from the cache are counted in the cache
+    long long bytes = diskUsage(dir.path().asString(), &_cache_files);
+    y2debug("Download area: added %s (%lld bytes)", dir.path().c_str(), bytes);
+
+    _entries.push_back(Entry(dir, bytes));
+    _usage += bytes;
+
+    updatePeak();
+    evict();
+}
+
+void DownloadArea::updatePeak()
+{
+    if (_usage + _cache_bytes > _peak)
+	_peak = _usage + _cache_bytes;
+}
+
+zypp::Pathname DownloadArea::cache(const zypp::Pathname &parent)
+{
+    if (!_cache)
+	_cache.reset(new zypp::filesystem::TmpDir(parent, "provide-cache."));
+
+    return _cache->path();
+}
+
+void DownloadArea::cached(const zypp::Pathname &file)
+{
+    struct stat st;
+
+    if (::lstat(file.c_str(), &st) != 0)
+	return;
+
+    std::pair<dev_t, ino_t> inode(st.st_dev, st.st_ino);
+    _cache_used[inode] = ++_uses;
+
+    // provided again
+    if (!_cache_files.insert(inode).second)
+	return;
+
+    _cache_bytes += st.st_size;
+    updatePeak();
+}
+
+bool DownloadArea::pin(const zypp::Pathname &path, bool pinned)
+{
+    std::string file(path.asString());
+
+    for (std::list<Entry>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+    {
+	std::string dir(it->dir.path().asString());
+
+	if (file == dir || file.compare(0, dir.size() + 1, dir + "/") == 0)
+	{
+	    it->pinned = pinned;
+	    // the most recently used
+	    _entries.splice(_entries.end(), _entries, it);
+	    return true;
+	}
+    }
+
+    y2warning("%s is not in the download area", file.c_str());
+    return false;
+}
+
+void DownloadArea::setLimit(long long bytes)
+{
+    _limit = bytes > 0 ? bytes : 0;
+    y2milestone("Download area limit: %lld bytes", _limit);
+
+    evict();
+}
+
+void DownloadArea::evict()
+{
+    if (_limit == 0 || _usage + _cache_bytes <= _limit || _entries.empty())
+	return;
+
+    // keep the last added directory, the caller is going to use it
+    std::list<Entry>::iterator last = --_entries.end();
+    std::list<Entry>::iterator it = _entries.begin();
+
+    while (it != last && _usage + _cache_bytes > _limit)
+    {
+	if (it->pinned)
+	{
+	    ++it;
+	    continue;
+	}
+
+	y2milestone("Download area: removing %s (%lld bytes)", it->dir.path().c_str(), it->bytes);
+	_usage -= it->bytes;
+	_evicted_bytes += it->bytes;
+	++_evictions;
+	it = _entries.erase(it);
+    }
+
+    if (_usage + _cache_bytes > _limit && _cache)
+	evictCache();
+
+    if (_usage + _cache_bytes > _limit)
+	y2warning("Download area: %lld bytes used, limit %lld bytes", _usage + _cache_bytes, _limit);
+}
+
+void DownloadArea::evictCache()
+{
+    std::vector<CachedFile> files;
+
+    bool read = walkFiles(_cache->path().asString(), [&](const std::string &path, const struct stat &st)
+    {
+	// the files linked from a directory would not be removed from the disk
+	if (st.st_nlink != 1)
+	    return;
+
+	CachedFile file;
+	file.path = path;
+	file.size = st.st_size;
+	file.inode = std::make_pair(st.st_dev, st.st_ino);
+
+	std::map<std::pair<dev_t, ino_t>, long long>::const_iterator used = _cache_used.find(file.inode);
+	file.used = used == _cache_used.end() ? 0 : used->second;
+
+	files.push_back(file);
+    });
+
+    if (!read)
+	y2warning("Cannot read the cache %s", _cache->path().c_str());
+
+    // the least recently used first
+    std::sort(files.begin(), files.end(),
+	[](const CachedFile &a, const CachedFile &b) { return a.used < b.used; });
+
+    long long removed = 0;
+
+    for (std::vector<CachedFile>::const_iterator it = files.begin();
+	it != files.end() && _usage + _cache_bytes > _limit; ++it)
+    {
+	if (::unlink(it->path.c_str()) != 0)
+	    continue;
+
+	if (_cache_files.erase(it->inode) > 0)
+	    _cache_bytes -= it->size;
+
+	_cache_used.erase(it->inode);
+
+	_evicted_bytes += it->size;
+	++_evictions;
+	++removed;
+    }
+
+    if (removed > 0)
+	y2milestone("Download area: removed %lld cached files, cache size %lld bytes", removed, _cache_bytes);
+}
+
+void DownloadArea::clear()
+{
+    _entries.clear();
+    _cache.reset();
+    _cache_files.clear();
+    _cache_used.clear();
+    _usage = 0;
+    _cache_bytes = 0;
+}
+
+YCPMap DownloadArea::stats() const
+{
+    long long pinned = 0;
+
+    for (std::list<Entry>::const_iterator it = _entries.begin(); it != _entries.end(); ++it)
+    {
+	if (it->pinned)
+	    ++pinned;
+    }
+
+    YCPMap ret;
+    ret->add(YCPString("limit"), YCPInteger(_limit));
+    ret->add(YCPString("usage"), YCPInteger(_usage + _cache_bytes));
+    ret->add(YCPString("peak"), YCPInteger(_peak));
+    ret->add(YCPString("entries"), YCPInteger((long long)_entries.size()));
+    ret->add(YCPString("pinned"), YCPInteger(pinned));
+    ret->add(YCPString("cache"), YCPInteger(_cache_bytes));
+    ret->add(YCPString("evictions"), YCPInteger(_evictions));
+    ret->add(YCPString("evicted_bytes"), YCPInteger(_evicted_bytes));
+
+    return ret;
+}
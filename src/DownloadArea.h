@@ -0,0 +1,116 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	DownloadArea.h
+   Summary:     Size limited download area for the provided files
+*/
+
+#ifndef DownloadArea_h
+#define DownloadArea_h
+
+#include <list>
+#include <map>
+#include <memory>
+
+#include "DiskUsage.h"
+
+#include <ycp/YCPMap.h>
+#include <zypp/Pathname.h>
+#include <zypp/TmpPath.h>
+
+/**
+ * Keeps the temporary directories with the provided files (SourceProvideSignedFile,
+ * SourceProvideFiles, ...) and the cache of the digested files.
+ *
+ * When the total size exceeds the limit the least recently used directories
+ * (provided or pinned/unpinned) not pinned by the caller are removed, then the least
+ * recently provided cached files which are not used by any directory. A cached file
+ * hardlinked to a directory is counted only once (in the cache).
+ */
+class DownloadArea
+{
+    public:
+
+	DownloadArea();
+
+	/**
+	 * Register a directory with the downloaded files,
+	 * removes the old directories if the limit is exceeded.
+	 * The new directory is never removed.
+	 */
+	void add(const zypp::filesystem::TmpDir &dir);
+
+	// the cache directory, created in the parent directory on demand
+	zypp::Pathname cache(const zypp::Pathname &parent);
+
+	// count a file added to the cache, or mark an already cached file as used
+	void cached(const zypp::Pathname &file);
+
+	/**
+	 * Pin (or unpin) the directory containing the path, a pinned directory
+	 * is not removed when the limit is exceeded. The directory is marked as used.
+	 * @return false if the path is not in the download area
+	 */
+	bool pin(const zypp::Pathname &path, bool pinned);
+
+	// the size limit in bytes, 0 = unlimited
+	void setLimit(long long bytes);
+
+	// remove everything
+	void clear();
+
+	// $[ "limit" : integer, "usage" : integer, "peak" : integer, "entries" : integer,
+	//   "pinned" : integer, "cache" : integer, "evictions" : integer, "evicted_bytes" : integer ]
+	YCPMap stats() const;
+
+    private:
+
+	void evict();
+
+	// remove the oldest cached files not linked from any directory
+	void evictCache();
+
+	void updatePeak();
+
+	struct Entry
+	{
+	    Entry(const zypp::filesystem::TmpDir &d, long long b) : dir(d), bytes(b), pinned(false) {}
+
+	    zypp::filesystem::TmpDir dir;
+	    long long bytes;
+	    bool pinned;
+	};
+
+	// the least recently used first
+	std::list<Entry> _entries;
+	std::unique_ptr<zypp::filesystem::TmpDir> _cache;
+	// the cached files (not counted in the directories)
+	InodeSet _cache_files;
+	// the last use of the cached files (the value of _uses)
+	std::map<std::pair<dev_t, ino_t>, long long> _cache_used;
+	long long _uses;
+
+	long long _limit;
+	long long _usage;
+	long long _cache_bytes;
+	long long _peak;
+	long long _evictions;
+	long long _evicted_bytes;
+};
+
+#endif // DownloadArea_h
@@ -0,0 +1,460 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	FileCopy.cc
+   Summary:     Native recursive copy (like "cp -a")
+*/
+
+#include "FileCopy.h"
+#include "log.h"
+
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+
+// the max. number of copying threads
+static const unsigned max_copy_threads = 8;
+
+namespace
+{
+    struct Item
+    {
+	std::string source;
+	std::string target;
+	struct stat st;
+    };
+
+    class TreeCopy
+    {
+	public:
+
+	    TreeCopy(bool backup) : _backup(backup), _failed(false), _next(0) {}
+
+	    bool run(const std::string &source, const std::string &target);
+
+	    const std::string& error() const { return _error; }
+
+	private:
+
+	    // create the directories and symlinks, collect the files
+	    void collect(const std::string &source, const std::string &target);
+
+	    void copyFiles();
+	    void copyFile(const Item &item);
+
+	    // set the owner, the permissions and the time stamps
+	    void setAttributes(const Item &item, int fd);
+
+	    bool backupTarget(const std::string &target);
+
+	    // create the hard links to the already copied files
+	    void linkFiles();
+
+	    void fail(const std::string &msg, const std::string &path, int err);
+	    void warning(const std::string &msg, const std::string &path, int err);
+
+	    // log the collected messages (from the main thread)
+	    void logMessages();
+
+	    bool _backup;
+	    std::vector<Item> _files;
+	    std::vector<Item> _dirs;
+
+	    // the hard links: (device, inode) => the first copied target
+	    std::map<std::pair<dev_t, ino_t>, std::string> _inodes;
+	    // the next links to the same inode: the item => the first target
+	    std::vector<std::pair<Item, std::string> > _links;
+
+	    // the messages from the copying threads (error flag, message)
+	    std::vector<std::pair<bool, std::string> > _messages;
+
+	    std::mutex _mutex;
+	    std::atomic<bool> _failed;
+	    std::atomic<size_t> _next;
+	    std::string _error;
+    };
+}
+
+void TreeCopy::fail(const std::string &msg, const std::string &path, int err)
+{
+    std::string text(msg + " " + path + ": " + ::strerror(err));
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _messages.push_back(std::make_pair(true, text));
+
+    // report the first error
+    if (!_failed.exchange(true))
+	_error = text;
+}
+
+void TreeCopy::warning(const std::string &msg, const std::string &path, int err)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _messages.push_back(std::make_pair(false, msg + " " + path + ": " + ::strerror(err)));
+}
+
+void TreeCopy::logMessages()
+{
+    for (std::vector<std::pair<bool, std::string> >::const_iterator it = _messages.begin(); it != _messages.end(); ++it)
+    {
+	if (it->first)
+	    y2error("%s", it->second.c_str());
+	else
+	    y2warning("%s", it->second.c_str());
+    }
+
+    _messages.clear();
+}
+
+bool TreeCopy::backupTarget(const std::string &target)
+{
+    if (!_backup || ::access(target.c_str(), F_OK) != 0)
+	return true;
+
+    std::string backup(target + "~");
+
+    if (::rename(target.c_str(), backup.c_str()) != 0)
+    {
+	fail("Cannot create backup of", target, errno);
+	return false;
+    }
+
+    return true;
+}
+
+void TreeCopy::collect(const std::string &source, const std::string &target)
+{
+    Item item;
+    item.source = source;
+    item.target = target;
+
+    if (::lstat(source.c_str(), &item.st) != 0)
+    {
+	fail("Cannot read", source, errno);
+	return;
+    }
+
+    if (S_ISDIR(item.st.st_mode))
+    {
+	struct stat target_st;
+	if (::mkdir(target.c_str(), 0700) != 0 && (errno != EEXIST || ::stat(target.c_str(), &target_st) != 0 || !S_ISDIR(target_st.st_mode)))
+	{
+	    fail("Cannot create directory", target, errno);
+	    return;
+	}
+
+	_dirs.push_back(item);
+
+	DIR *dir = ::opendir(source.c_str());
+	if (!dir)
+	{
+	    fail("Cannot read directory", source, errno);
+	    return;
+	}
+
+	struct dirent *entry;
+	while ((entry = ::readdir(dir)) != NULL && !_failed)
+	{
+	    std::string name(entry->d_name);
+
+	    if (name == "." || name == "..")
+		continue;
+
+	    collect(source + "/" + name, target + "/" + name);
+	}
+
+	::closedir(dir);
+    }
+    else if (S_ISREG(item.st.st_mode))
+    {
+	if (item.st.st_nlink > 1)
+	{
+	    std::pair<std::map<std::pair<dev_t, ino_t>, std::string>::iterator, bool> inserted =
+		_inodes.insert(std::make_pair(std::make_pair(item.st.st_dev, item.st.st_ino), target));
+
+	    // already copied, create a hard link later (like "cp -a")
+	    if (!inserted.second)
+	    {
+		_links.push_back(std::make_pair(item, inserted.first->second));
+		return;
+	    }
+	}
+
+	_files.push_back(item);
+    }
+    else if (S_ISLNK(item.st.st_mode))
+    {
+	std::vector<char> link(item.st.st_size + 1);
+	ssize_t size = ::readlink(source.c_str(), link.data(), link.size());
+
+	if (size < 0 || (size_t)size >= link.size())
+	{
+	    fail("Cannot read symlink", source, size < 0 ? errno : ENAMETOOLONG);
+	    return;
+	}
+
+	link[size] = '\0';
+
+	if (!backupTarget(target))
+	    return;
+
+	::unlink(target.c_str());
+
+	if (::symlink(link.data(), target.c_str()) != 0)
+	{
+	    fail("Cannot create symlink", target, errno);
+	    return;
+	}
+
+	setAttributes(item, -1);
+    }
+    else
+    {
+	y2warning("Skipping special file %s", source.c_str());
+    }
+}
+
+void TreeCopy::setAttributes(const Item &item, int fd)
+{
+    struct timespec times[2] = { item.st.st_atim, item.st.st_mtim };
+
+    if (fd >= 0)
+    {
+	// the owner can be changed only by root, keep the current owner otherwise (like cp)
+	if (::fchown(fd, item.st.st_uid, item.st.st_gid) != 0 && errno != EPERM)
+	    warning("Cannot change owner of", item.target, errno);
+
+	if (::fchmod(fd, item.st.st_mode & 07777) != 0)
+	    warning("Cannot change permissions of", item.target, errno);
+
+	if (::futimens(fd, times) != 0)
+	    warning("Cannot set time stamps of", item.target, errno);
+    }
+    else
+    {
+	int flags = S_ISLNK(item.st.st_mode) ? AT_SYMLINK_NOFOLLOW : 0;
+
+	if (::fchownat(AT_FDCWD, item.target.c_str(), item.st.st_uid, item.st.st_gid, flags) != 0 && errno != EPERM)
+	    warning("Cannot change owner of", item.target, errno);
+
+	// symlinks do not have permissions
+	if (!S_ISLNK(item.st.st_mode) && ::chmod(item.target.c_str(), item.st.st_mode & 07777) != 0)
+	    warning("Cannot change permissions of", item.target, errno);
+
+	if (::utimensat(AT_FDCWD, item.target.c_str(), times, flags) != 0)
+	    warning("Cannot set time stamps of", item.target, errno);
+    }
+}
+
+void TreeCopy::copyFile(const Item &item)
+{
+    if (!backupTarget(item.target))
+	return;
+
+    int in = ::open(item.source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0)
+    {
+	fail("Cannot open", item.source, errno);
+	return;
+    }
+
+    int out = ::open(item.target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (out < 0)
+    {
+	fail("Cannot create", item.target, errno);
+	::close(in);
+	return;
+    }
+
+    bool done = false;
+
+#ifdef FICLONE
+    // share the data blocks (btrfs, XFS), no copying at all
+    done = ::ioctl(out, FICLONE, in) == 0;
+#endif
+
+    // copy in kernel, the data is not copied to the user space
+    bool in_kernel = true;
+
+    while (!done)
+    {
+	ssize_t copied = in_kernel ? ::copy_file_range(in, NULL, out, NULL, 1 << 30, 0) : -1;
+
+	if (copied == 0)
+	{
+	    done = true;
+	}
+	else if (copied < 0)
+	{
+	    if (in_kernel && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP))
+	    {
+		// not supported (old kernel, different filesystems), use read/write
+		in_kernel = false;
+		continue;
+	    }
+
+	    if (in_kernel)
+	    {
+		fail("Cannot copy", item.source, errno);
+		break;
+	    }
+
+	    // read/write fallback, continue from the current offset
+	    char buffer[64 * 1024];
+	    ssize_t size = ::read(in, buffer, sizeof(buffer));
+
+	    if (size < 0 && errno == EINTR)
+		continue;
+
+	    if (size < 0)
+	    {
+		fail("Cannot read", item.source, errno);
+		break;
+	    }
+
+	    if (size == 0)
+	    {
+		done = true;
+		break;
+	    }
+
+	    for (ssize_t written = 0; written < size; )
+	    {
+		ssize_t ret = ::write(out, buffer + written, size - written);
+
+		if (ret < 0 && errno == EINTR)
+		    continue;
+
+		if (ret < 0)
+		{
+		    fail("Cannot write", item.target, errno);
+		    break;
+		}
+
+		written += ret;
+	    }
+
+	    if (_failed)
+		break;
+	}
+    }
+
+    if (done)
+	setAttributes(item, out);
+
+    if (::close(out) != 0 && done)
+	fail("Cannot write", item.target, errno);
+
+    ::close(in);
+}
+
+void TreeCopy::linkFiles()
+{
+    for (std::vector<std::pair<Item, std::string> >::const_iterator it = _links.begin(); it != _links.end() && !_failed; ++it)
+    {
+	const std::string &target = it->first.target;
+
+	if (!backupTarget(target))
+	    return;
+
+	::unlink(target.c_str());
+
+	if (::link(it->second.c_str(), target.c_str()) != 0)
+	    fail("Cannot create hard link", target, errno);
+    }
+}
+
+void TreeCopy::copyFiles()
+{
+    size_t index;
+
+    while (!_failed && (index = _next++) < _files.size())
+	copyFile(_files[index]);
+}
+
+bool TreeCopy::run(const std::string &source, const std::string &target)
+{
+    collect(source, target);
+
+    if (!_failed && !_files.empty())
+    {
+	unsigned count = std::min<size_t>(std::max(1u, std::min(std::thread::hardware_concurrency(), max_copy_threads)), _files.size());
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 1; i < count; ++i)
+	    threads.push_back(std::thread(&TreeCopy::copyFiles, this));
+
+	// copy in the current thread as well
+	copyFiles();
+
+	for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+	    it->join();
+    }
+
+    // the linked files must be copied first
+    if (!_failed)
+	linkFiles();
+
+    // set the directory attributes at the end, copying the files changes the time stamps,
+    // the subdirectories first (a read-only directory)
+    for (std::vector<Item>::reverse_iterator it = _dirs.rbegin(); it != _dirs.rend(); ++it)
+	setAttributes(*it, -1);
+
+    // log after joining the threads
+    logMessages();
+
+    y2milestone("Copied %zu files, %zu hard links and %zu directories from %s", _files.size(), _links.size(), _dirs.size(), source.c_str());
+
+    return !_failed;
+}
+
+bool copyTree(const std::string &source, const std::string &target, bool backup, std::string &error)
+{
+    std::string name(source);
+
+    // remove the trailing slashes
+    while (name.size() > 1 && name[name.size() - 1] == '/')
+	name.erase(name.size() - 1);
+
+    std::string::size_type pos = name.rfind('/');
+    if (pos != std::string::npos)
+	name.erase(0, pos + 1);
+
+    TreeCopy copy(backup);
+
+    if (!copy.run(source, target + "/" + name))
+    {
+	error = copy.error();
+	return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,45 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	FileCopy.h
+   Summary:     Native recursive copy (like "cp -a")
+*/
+
+#ifndef FileCopy_h
+#define FileCopy_h
+
+#include <string>
+
+/**
+ * Copy a file or a directory tree into the target directory (like "cp -a source target"),
+ * preserves the permissions, the owner and the time stamps, symlinks are copied as symlinks
+ * and hard links (within the copied tree) as hard links.
+ *
+ * The file content is cloned (FICLONE) if the filesystem supports reflinks, otherwise
+ * it is copied in kernel by copy_file_range() (or read()/write() as a fallback).
+ * The files are copied by several threads at once.
+ *
+ * @param source the source file or directory
+ * @param target the target directory (must exist)
+ * @param backup rename the existing target files to "<name>~" (like "cp -b")
+ * @param error the error description
+ * @return true on success
+ */
+bool copyTree(const std::string &source, const std::string &target, bool backup, std::string &error);
+
+#endif // FileCopy_h
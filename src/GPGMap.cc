@@ -27,10 +27,6 @@
 #include "GPGMap.h"
 #include "i18n.h"
 
-#include <ycp/YCPString.h>
-#include <ycp/YCPInteger.h>
-#include <ycp/YCPBoolean.h>
-
 #include <zypp/Date.h>
 #include <zypp/PublicKey.h>
 
@@ -39,25 +35,26 @@
 */
 
 GPGMap::GPGMap(const zypp::PublicKey &key)
+    : gpg_map(PlainValue::map())
 {
-    gpg_map->add(YCPString("id"), YCPString(key.id()));
-    gpg_map->add(YCPString("name"), YCPString(key.name()));
-    gpg_map->add(YCPString("fingerprint"), YCPString(key.fingerprint()));
-    gpg_map->add(YCPString("path"), YCPString(key.path().asString()));
+    gpg_map.add("id", PlainValue::string(key.id()));
+    gpg_map.add("name", PlainValue::string(key.name()));
+    gpg_map.add("fingerprint", PlainValue::string(key.fingerprint()));
+    gpg_map.add("path", PlainValue::string(key.path().asString()));
 
     zypp::Date date(key.created());
     // %x = date only, see man strftime
-    gpg_map->add(YCPString("created"), YCPString(date.form("%x")));
-    gpg_map->add(YCPString("created_raw"), YCPInteger(zypp::Date::ValueType(date)));
+    gpg_map.add("created", PlainValue::string(date.form("%x")));
+    gpg_map.add("created_raw", PlainValue::integer(zypp::Date::ValueType(date)));
 
     date = key.expires();
     std::string expires((date == 0) ? _("Never") : date.form("%x"));
-    gpg_map->add(YCPString("expires"), YCPString(expires));
-    gpg_map->add(YCPString("expires_raw"), YCPInteger(zypp::Date::ValueType(date)));
+    gpg_map.add("expires", PlainValue::string(expires));
+    gpg_map.add("expires_raw", PlainValue::integer(zypp::Date::ValueType(date)));
 }
 
 void GPGMap::setTrusted(bool trusted)
 {
     // is the key trusted?
-    gpg_map->add(YCPString("trusted"), YCPBoolean(trusted));
+    gpg_map.add("trusted", PlainValue::boolean(trusted));
 }
@@ -30,6 +30,7 @@ namespace zypp
 }
 
 #include <ycp/YCPMap.h>
+#include "PlainValue.h"
 
 class GPGMap
 {
@@ -39,13 +40,20 @@ class GPGMap
 
 	void setTrusted(bool trusted);
 
+	// call it only in the main thread
 	YCPMap getMap() const
+	{
+	    return gpg_map.toYCP()->asMap();
+	}
+
+	// can be used in a worker thread (in the callbacks)
+	const PlainValue& getValue() const
 	{
 	    return gpg_map;
 	}
 
     private:
 
-	YCPMap gpg_map;
+	PlainValue gpg_map;
 };
 
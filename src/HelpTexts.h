@@ -54,5 +54,8 @@ namespace HelpTexts
 
 	static const char *refresh_help = _("<P><BIG><B>Refreshing the Repository</B></BIG></P>"
 "<P>The package manager is updating the repository content...</P>");
+
+	static const char *prefetch_help = _("<P><BIG><B>Downloading Packages</B></BIG></P>"
+"<P>The package manager is downloading the packages to install...</P>");
 }
 
@@ -0,0 +1,99 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	LoadStats.cc
+   Summary:     Per repository statistics of the repository loading
+*/
+
+#include "LoadStats.h"
+#include "log.h"
+
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPString.h>
+
+#include <cstdio>
+
+static const char *phase_names[LoadStats::PhaseCount] = { "check", "download", "build", "load", "forked" };
+
+LoadStats::Timer::~Timer()
+{
+    _stats.add(_alias, _phase,
+	std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count());
+}
+
+void LoadStats::add(const std::string &alias, Phase phase, double seconds)
+{
+    _stats[alias].time[phase] += seconds;
+}
+
+void LoadStats::addDownloaded(const std::string &alias, long long bytes)
+{
+    _stats[alias].bytes += bytes;
+}
+
+void LoadStats::addSolvables(const std::string &alias, long long count)
+{
+    _stats[alias].solvables += count;
+}
+
+void LoadStats::reset()
+{
+    _stats.clear();
+}
+
+YCPMap LoadStats::asYCPMap() const
+{
+    YCPMap ret;
+
+    for (Stats::const_iterator it = _stats.begin(); it != _stats.end(); ++it)
+    {
+	YCPMap entry;
+
+	for (unsigned phase = 0; phase < PhaseCount; ++phase)
+	    entry->add(YCPString(phase_names[phase]), YCPInteger((long long)(it->second.time[phase] * 1000)));
+
+	entry->add(YCPString("download_bytes"), YCPInteger(it->second.bytes));
+	entry->add(YCPString("solvables"), YCPInteger(it->second.solvables));
+
+	ret->add(YCPString(it->first), entry);
+    }
+
+    return ret;
+}
+
+void LoadStats::log() const
+{
+    if (_stats.empty())
+	return;
+
+    std::string summary;
+
+    for (Stats::const_iterator it = _stats.begin(); it != _stats.end(); ++it)
+    {
+	char buffer[512];
+	const double *time = it->second.time;
+
+	::snprintf(buffer, sizeof(buffer), "%s%s: check %.2fs, download %.2fs (%lldKiB), build %.2fs, load %.2fs, forked %.2fs, %lld solvables",
+	    summary.empty() ? "" : "; ", it->first.c_str(), time[Check], time[Download], it->second.bytes >> 10,
+	    time[Build], time[Load], time[Forked], it->second.solvables);
+
+	summary += buffer;
+    }
+
+    y2milestone("Repository load stats: %s", summary.c_str());
+}
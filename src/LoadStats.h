@@ -0,0 +1,108 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	LoadStats.h
+   Summary:     Per repository statistics of the repository loading
+*/
+
+#ifndef LoadStats_h
+#define LoadStats_h
+
+#include <map>
+#include <string>
+#include <chrono>
+
+#include <ycp/YCPMap.h>
+
+/**
+ * Collects the time spent in the load phases of each repository (or service),
+ * the size of the downloaded metadata and the number of loaded solvables.
+ */
+class LoadStats
+{
+    public:
+
+	enum Phase
+	{
+	    // checkIfToRefreshMetadata()
+	    Check,
+	    // refreshing the metadata
+	    Download,
+	    // building the solv cache
+	    Build,
+	    // loadFromCache()
+	    Load,
+	    // a job in a forked process (refresh and/or cache build)
+	    Forked,
+	    PhaseCount
+	};
+
+	/**
+	 * Measures the time of a phase, the time is added in the destructor
+	 * (i.e. also when an exception is thrown).
+	 */
+	class Timer
+	{
+	    public:
+		Timer(LoadStats &stats, const std::string &alias, Phase phase)
+		    : _stats(stats), _alias(alias), _phase(phase), _start(std::chrono::steady_clock::now())
+		{}
+
+		~Timer();
+
+	    private:
+		LoadStats &_stats;
+		std::string _alias;
+		Phase _phase;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	// add time (in seconds) to the phase of the repository
+	void add(const std::string &alias, Phase phase, double seconds);
+
+	// add the downloaded bytes (see TransferStats::bytes())
+	void addDownloaded(const std::string &alias, long long bytes);
+
+	void addSolvables(const std::string &alias, long long count);
+
+	void reset();
+
+	// alias -> $[ "check" : integer, "download" : integer, "build" : integer,
+	//   "load" : integer, "forked" : integer (times in milliseconds),
+	//   "download_bytes" : integer, "solvables" : integer ]
+	YCPMap asYCPMap() const;
+
+	// log a summary line
+	void log() const;
+
+    private:
+
+	struct Entry
+	{
+	    Entry() : time(), bytes(0), solvables(0) {}
+
+	    double time[PhaseCount];
+	    long long bytes;
+	    long long solvables;
+	};
+
+	typedef std::map<std::string, Entry> Stats;
+	Stats _stats;
+};
+
+#endif // LoadStats_h
@@ -0,0 +1,175 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	MirrorRank.cc
+   Summary:     Ordering the repository base URLs by the server latency
+*/
+
+#include "MirrorRank.h"
+#include "log.h"
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+// the max. time for connecting a server (in milliseconds)
+static const int probe_timeout = 2000;
+
+std::string MirrorRank::server(const zypp::Url &url)
+{
+    if (!url.schemeIsDownloading() || url.getHost().empty())
+	return std::string();
+
+    std::string port(url.getPort());
+
+    if (port.empty())
+    {
+	std::string scheme(url.getScheme());
+	port = scheme == "https" ? "443" : scheme == "ftp" ? "21" : scheme == "tftp" ? "69" : scheme == "sftp" ? "22" : "80";
+    }
+
+    return url.getHost() + ":" + port;
+}
+
+double MirrorRank::measure(const std::string &host, const std::string &port)
+{
+    struct addrinfo hints = {};
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *result = NULL;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result)
+	return -1.0;
+
+    double ret = -1.0;
+
+    // use the first address which can be connected
+    for (struct addrinfo *addr = result; addr && ret < 0; addr = addr->ai_next)
+    {
+	int fd = ::socket(addr->ai_family, addr->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, addr->ai_protocol);
+
+	if (fd < 0)
+	    continue;
+
+	if (::connect(fd, addr->ai_addr, addr->ai_addrlen) == 0 || errno == EINPROGRESS)
+	{
+	    struct pollfd pfd = { fd, POLLOUT, 0 };
+	    int error = 0;
+	    socklen_t len = sizeof(error);
+
+	    if (::poll(&pfd, 1, probe_timeout) == 1
+		&& ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 && error == 0)
+	    {
+		// including the DNS lookup
+		ret = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	    }
+	}
+
+	::close(fd);
+    }
+
+    ::freeaddrinfo(result);
+
+    return ret;
+}
+
+void MirrorRank::probe(const std::list<zypp::Url> &urls)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::vector<std::string> servers;
+    std::vector<std::pair<std::string, std::string> > addresses;
+
+    for (std::list<zypp::Url>::const_iterator it = urls.begin(); it != urls.end(); ++it)
+    {
+	std::string s(server(*it));
+
+	if (s.empty() || std::find(servers.begin(), servers.end(), s) != servers.end())
+	    continue;
+
+	std::map<std::string, Entry>::const_iterator cached = _servers.find(s);
+
+	if (cached != _servers.end() && now - cached->second.measured < std::chrono::seconds(_ttl))
+	    continue;
+
+	servers.push_back(s);
+	addresses.push_back(std::make_pair(it->getHost(), s.substr(s.rfind(':') + 1)));
+    }
+
+    if (servers.empty())
+	return;
+
+    y2milestone("Probing %zu servers", servers.size());
+
+    // the threads write only their own item
+    std::vector<double> latencies(servers.size(), -1.0);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < servers.size(); ++i)
+    {
+	threads.push_back(std::thread([&addresses, &latencies, i] {
+	    latencies[i] = measure(addresses[i].first, addresses[i].second);
+	}));
+    }
+
+    for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+	it->join();
+
+    for (size_t i = 0; i < servers.size(); ++i)
+    {
+	Entry entry;
+	entry.latency = latencies[i];
+	entry.measured = now;
+	_servers[servers[i]] = entry;
+
+	if (latencies[i] < 0)
+	    y2warning("Server %s is not reachable", servers[i].c_str());
+	else
+	    y2milestone("Server %s latency: %.1fms", servers[i].c_str(), latencies[i] * 1000);
+    }
+}
+
+std::list<zypp::Url> MirrorRank::sort(const std::list<zypp::Url> &urls) const
+{
+    std::vector<std::pair<double, zypp::Url> > ranked;
+
+    for (std::list<zypp::Url>::const_iterator it = urls.begin(); it != urls.end(); ++it)
+    {
+	std::map<std::string, Entry>::const_iterator s = _servers.find(server(*it));
+	double latency = (s == _servers.end() || s->second.latency < 0) ? 1e9 : s->second.latency;
+
+	ranked.push_back(std::make_pair(latency, *it));
+    }
+
+    std::stable_sort(ranked.begin(), ranked.end(),
+	[](const std::pair<double, zypp::Url> &a, const std::pair<double, zypp::Url> &b) { return a.first < b.first; });
+
+    std::list<zypp::Url> ret;
+
+    for (std::vector<std::pair<double, zypp::Url> >::const_iterator it = ranked.begin(); it != ranked.end(); ++it)
+	ret.push_back(it->second);
+
+    return ret;
+}
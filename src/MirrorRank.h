@@ -0,0 +1,77 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	MirrorRank.h
+   Summary:     Ordering the repository base URLs by the server latency
+*/
+
+#ifndef MirrorRank_h
+#define MirrorRank_h
+
+#include <map>
+#include <list>
+#include <string>
+#include <chrono>
+
+#include <zypp/Url.h>
+
+/**
+ * Measures the latency of the servers (the time of the TCP connection setup)
+ * and orders the base URLs of a repository by it, the nearest server first.
+ *
+ * The servers are probed in parallel (in threads, libzypp is not used),
+ * the latencies are cached for the TTL.
+ */
+class MirrorRank
+{
+    public:
+
+	MirrorRank() : _ttl(600) {}
+
+	// how long the measured latency is valid (in seconds)
+	void setTTL(unsigned ttl) { _ttl = ttl; }
+
+	// measure the servers which have not been measured recently
+	void probe(const std::list<zypp::Url> &urls);
+
+	/**
+	 * Sort the URLs by the latency of the servers, the unreachable and not measured
+	 * servers are moved to the end, the configured order is kept for the same latency.
+	 */
+	std::list<zypp::Url> sort(const std::list<zypp::Url> &urls) const;
+
+    private:
+
+	// "host:port" or empty for a not downloading URL
+	static std::string server(const zypp::Url &url);
+
+	// the latency in seconds, negative if the server is not reachable
+	static double measure(const std::string &host, const std::string &port);
+
+	struct Entry
+	{
+	    double latency;
+	    std::chrono::steady_clock::time_point measured;
+	};
+
+	// the cached latencies ("host:port" -> latency)
+	std::map<std::string, Entry> _servers;
+	unsigned _ttl;
+};
+
+#endif // MirrorRank_h
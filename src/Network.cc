@@ -28,9 +28,20 @@
 
 #include <PkgFunctions.h>
 #include "log.h"
+#include "ProcessPool.h"
 
-// system()
-#include <cstdlib>
+#include <chrono>
+#include <mutex>
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 
 #include <zypp/Url.h>
 
@@ -38,19 +49,153 @@
   Textdomain "pkg-bindings"
 */
 
+// the cached network status is valid at most this time
+static const std::chrono::seconds network_status_ttl(5);
+
+static std::mutex network_mutex;
+static bool network_status_valid = false;
+static bool network_status = false;
+static std::chrono::steady_clock::time_point network_status_time;
+// netlink socket receiving the link and address changes, -1 if not available
+static int netlink_fd = -2;
+
+// open a non-blocking netlink socket subscribed to the link and address changes
+static int openNetlink()
+{
+    int fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+
+    if (fd < 0)
+    {
+	y2warning("Cannot open netlink socket, the network status will be checked after %llds",
+	    (long long)network_status_ttl.count());
+	return -1;
+    }
+
+    struct sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+
+    if (::bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+	y2warning("Cannot bind netlink socket");
+	::close(fd);
+	return -1;
+    }
+
+    return fd;
+}
+
+// read all pending netlink messages, returns true if there was any change
+// (or the socket has overflowed and some changes might have been lost)
+static bool networkChanged()
+{
+    if (netlink_fd < 0)
+	return false;
+
+    bool changed = false;
+    char buffer[4096];
+
+    while (true)
+    {
+	ssize_t len = ::recv(netlink_fd, buffer, sizeof(buffer), 0);
+
+	if (len > 0)
+	    changed = true;
+	else if (len < 0 && errno == EINTR)
+	    continue;
+	else
+	{
+	    // ENOBUFS - some messages have been dropped
+	    if (len < 0 && errno == ENOBUFS)
+		changed = true;
+
+	    break;
+	}
+    }
+
+    return changed;
+}
+
+// is there a configured non-loopback address?
+static bool networkAddressPresent()
+{
+    struct ifaddrs *ifaddr;
+
+    if (::getifaddrs(&ifaddr) < 0)
+    {
+	y2error("getifaddrs() failed, assuming running network");
+	return true;
+    }
+
+    bool ret = false;
+
+    for (struct ifaddrs *ifa = ifaddr; ifa && !ret; ifa = ifa->ifa_next)
+    {
+	if (!ifa->ifa_addr || !(ifa->ifa_flags & IFF_UP) || (ifa->ifa_flags & IFF_LOOPBACK))
+	    continue;
+
+	if (ifa->ifa_addr->sa_family == AF_INET)
+	{
+	    const struct sockaddr_in *sin = (const struct sockaddr_in *)ifa->ifa_addr;
+	    // ignore 127.0.0.0/8
+	    ret = (ntohl(sin->sin_addr.s_addr) >> 24) != 127;
+	}
+	else if (ifa->ifa_addr->sa_family == AF_INET6)
+	{
+	    // only a global address, a link local address is always present
+	    const struct in6_addr *addr = &((const struct sockaddr_in6 *)ifa->ifa_addr)->sin6_addr;
+	    ret = !IN6_IS_ADDR_LOOPBACK(addr) && !IN6_IS_ADDR_LINKLOCAL(addr)
+		&& !IN6_IS_ADDR_SITELOCAL(addr) && !IN6_IS_ADDR_MULTICAST(addr)
+		&& !IN6_IS_ADDR_UNSPECIFIED(addr);
+	}
+
+	if (ret)
+	    y2debug("Found network address at %s", ifa->ifa_name);
+    }
+
+    ::freeifaddrs(ifaddr);
+
+    return ret;
+}
+
 /*
   A helper function
-  Detect whether there is a network connection.
+  Detect whether there is a network connection (an IPv4 or a global IPv6 address).
   See isNetworkRunning() function in NetworkService.ycp
+
+  The result is cached until a netlink link/address change is received,
+  at most for a few seconds.
 */
 bool PkgFunctions::NetworkDetected()
 {
-    y2milestone("Checking the network status...");
-    // check IPv4 network
-    int result = ::system("ip addr|grep -v '127.0.0\\|inet6'|grep -q inet &> /dev/null");
-    y2milestone("Network is running: %s", (result == 0) ? "yes" : "no");
+    // do not share the netlink socket with the parent process
+    if (ProcessPool::inChild())
+	return networkAddressPresent();
+
+    std::lock_guard<std::mutex> lock(network_mutex);
+
+    if (netlink_fd == -2)
+	netlink_fd = openNetlink();
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (networkChanged() || now - network_status_time > network_status_ttl)
+	network_status_valid = false;
+
+    if (!network_status_valid)
+    {
+	y2milestone("Checking the network status...");
+	network_status = networkAddressPresent();
+	network_status_valid = true;
+	network_status_time = now;
+	y2milestone("Network is running: %s", network_status ? "yes" : "no");
+    }
+    else
+    {
+	y2debug("Network is running: %s (cached)", network_status ? "yes" : "no");
+    }
 
-    return !result;
+    return network_status;
 }
 
 /*
@@ -121,6 +121,7 @@ PkgFunctions::PkgQueryProvides( const YCPString& tag )
     zypp::sat::WhatProvides possibleProviders(cap);
 
     y2milestone("Searching packages providing: %s", name.c_str());
+    LogBudget log_budget("found package");
 
     for_(iter, possibleProviders.begin(), possibleProviders.end())
     {
@@ -137,7 +138,8 @@ PkgFunctions::PkgQueryProvides( const YCPString& tag )
 
 	std::string pkgname = package->name();
 
-        MIL << "Found package: " << package << std::endl;
+	if (log_budget.allow())
+	    MIL << "Found package: " << package << std::endl;
 
 	// get instance status
 	bool installed = provider.status().staysInstalled();
@@ -265,7 +267,11 @@ PkgFunctions::PkgMediaNames ()
 	}
     }
 
-    y2milestone( "Pkg::PkgMediaNames result: %s", res->toString().c_str());
+    // the full result can be long, log it only in the debug mode
+    if (get_log_debug())
+	y2debug("Pkg::PkgMediaNames result: %s", res->toString().c_str());
+    else
+	y2milestone("Pkg::PkgMediaNames result: %d repositories", res->size());
 
     return res;
 }
@@ -364,7 +370,13 @@ PkgFunctions::PkgMediaSizesOrCount (bool sizes, bool download_size)
 	res->add( source );
     }
 
-    y2milestone( "Pkg::%s result: %s", sizes ? (download_size ? "PkgMediaPackageSizes" : "PkgMediaSizes" ): "PkgMediaCount", res->toString().c_str());
+    const char *builtin = sizes ? (download_size ? "PkgMediaPackageSizes" : "PkgMediaSizes" ): "PkgMediaCount";
+
+    // the full result can be long, log it only in the debug mode
+    if (get_log_debug())
+	y2debug("Pkg::%s result: %s", builtin, res->toString().c_str());
+    else
+	y2milestone("Pkg::%s result: %d repositories", builtin, res->size());
 
     return res;
 }
@@ -2126,7 +2138,7 @@ namespace
   ///////////////////////////////////////////////////////////////////
 } // namespace
 
-YCPValue PkgFunctions::CommitHelper(const zypp::ZYppCommitPolicy *policy)
+PlainValue PkgFunctions::CommitHelper(const zypp::ZYppCommitPolicy *policy)
 {
     OldStyleCommitResult result;
 
@@ -2145,86 +2157,83 @@ YCPValue PkgFunctions::CommitHelper(const zypp::ZYppCommitPolicy *policy)
     catch (const zypp::target::TargetAbortedException & excpt)
     {
 	y2milestone ("Installation aborted by user");
-	YCPList ret;
-	ret->add(YCPInteger(-1));
+	PlainValue ret(PlainValue::list());
+	ret.add(PlainValue::integer(-1));
 	return ret;
     }
     catch (const zypp::Exception& excpt)
     {
 	y2error("Pkg::Commit has failed: ZYpp::commit has failed");
 	_last_error.setLastError(ExceptionAsString(excpt));
-	return YCPVoid();
+	return PlainValue();
     }
 
-    SourceReleaseAll();
+    SourceReleaseAllImpl();
 
     // create the base product link (bnc#413444)
     CreateBaseProductSymlink();
 
-    YCPList ret;
+    PlainValue ret(PlainValue::list());
 
-    ret->add(YCPInteger(result._result));
+    ret.add(PlainValue::integer(result._result));
 
-    YCPList errlist;
+    PlainValue errlist(PlainValue::list());
     for (zypp::PoolItemList::const_iterator it = result._errors.begin(); it != result._errors.end(); ++it)
     {
-	errlist->add(YCPString(it->resolvable()->name()));
+	errlist.add(PlainValue::string(it->resolvable()->name()));
     }
-    ret->add(errlist);
+    ret.add(errlist);
 
-    YCPList remlist;
+    PlainValue remlist(PlainValue::list());
     for (zypp::PoolItemList::const_iterator it = result._remaining.begin(); it != result._remaining.end(); ++it)
     {
-	YCPMap resolvable;
-	resolvable->add (YCPString ("name"),
-	    YCPString(it->resolvable()->name()));
+	PlainValue resolvable(PlainValue::map());
+	resolvable.add("name", PlainValue::string(it->resolvable()->name()));
 	if (zypp::isKind<zypp::Product>(it->resolvable()))
-	    resolvable->add (YCPString ("kind"), YCPSymbol ("product"));
+	    resolvable.add("kind", PlainValue::symbol("product"));
 	else if (zypp::isKind<zypp::Pattern>(it->resolvable()))
-	    resolvable->add (YCPString ("kind"), YCPSymbol ("pattern"));
+	    resolvable.add("kind", PlainValue::symbol("pattern"));
 	else if (zypp::isKind<zypp::Patch>(it->resolvable()))
-	    resolvable->add (YCPString ("kind"), YCPSymbol ("patch"));
+	    resolvable.add("kind", PlainValue::symbol("patch"));
 	else
-	    resolvable->add (YCPString ("kind"), YCPSymbol ("package"));
-	resolvable->add (YCPString ("arch"),
-	    YCPString (it->resolvable()->arch().asString()));
-	resolvable->add (YCPString ("version"),
-	    YCPString (it->resolvable()->edition().asString()));
-	remlist->add(resolvable);
+	    resolvable.add("kind", PlainValue::symbol("package"));
+	resolvable.add("arch", PlainValue::string(it->resolvable()->arch().asString()));
+	resolvable.add("version", PlainValue::string(it->resolvable()->edition().asString()));
+	remlist.add(resolvable);
     }
-    ret->add(remlist);
+    ret.add(remlist);
 
-    YCPList srclist;
+    PlainValue srclist(PlainValue::list());
     for (zypp::PoolItemList::const_iterator it = result._srcremaining.begin(); it != result._srcremaining.end(); ++it)
     {
-	srclist->add(YCPString(it->resolvable()->name()));
+	srclist.add(PlainValue::string(it->resolvable()->name()));
     }
-    ret->add(srclist);
+    ret.add(srclist);
 
   /* Retrieve installation/update messages from libzypp */
-  YCPList msglist;
+  PlainValue msglist(PlainValue::list());
   for (zypp::UpdateNotifications::const_iterator it = result._updateMessages.begin(); it != result._updateMessages.end(); ++it)
   {
     std::string messagePath = zypp::Pathname::assertprefix(_target_root, it->file()).asString();
     std::ifstream in(messagePath, std::ios::in);
     if (in) { /* If the file exists, read the content */
-      YCPMap msg;
+      PlainValue msg(PlainValue::map());
       std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
       /* Package name */
-      msg->add(YCPString("solvable"), YCPString(it->solvable().name()));
+      msg.add("solvable", PlainValue::string(it->solvable().name()));
       /* Where the message can be found after installation */
-      msg->add(YCPString("installationPath"), YCPString(it->file().asString()));
+      msg.add("installationPath", PlainValue::string(it->file().asString()));
       /* Where the message can be found currently (during installation differs from installationPath) */
-      msg->add(YCPString("currentPath"), YCPString(messagePath));
+      msg.add("currentPath", PlainValue::string(messagePath));
       /* Message content */
-      msg->add(YCPString("text"), YCPString(text));
-      msglist->add(msg);
+      msg.add("text", PlainValue::string(text));
+      msglist.add(msg);
       in.close();
     } else { /* If the file does not exist (unexpected), log the error */
       y2error("Message file couldn't be found: %s", messagePath.c_str());
     }
   }
-  ret->add(msglist);
+  ret.add(msglist);
 
     return ret;
 }
@@ -2299,7 +2308,7 @@ PkgFunctions::PkgCommit (const YCPInteger& media)
     commit_policy = new zypp::ZYppCommitPolicy;
     commit_policy->restrictToMedia(medianr);
 
-    YCPValue ret = CommitHelper(commit_policy);
+    YCPValue ret = CommitHelper(commit_policy).toYCP();
 
     delete commit_policy;
     commit_policy = NULL;
@@ -2316,17 +2325,32 @@ PkgFunctions::PkgCommit (const YCPInteger& media)
  * @param map commit configuration, currently supported values:
  *   $["download_mode":`default|`download_only|`download_only|`download_in_advance|
  *      `download_in_heaps|`download_as_needed, "medium_nr":<integer>,
- *      "dry_run":<boolean>, "exclude_docs":<boolean>, "no_signature":<boolean>],
+ *      "dry_run":<boolean>, "exclude_docs":<boolean>, "no_signature":<boolean>,
+ *      "pipeline":$["depth":<integer>]],
  *   the default is $["download_mode":`default, "medium_nr":0 (all media),
  *      "dry_run":false, "exclude_docs":false, "no_signature":false],
+ *   "pipeline" - download the next "depth" packages (in parallel) while installing
+ *      the current package, implies `download_as_needed (a different explicit
+ *      "download_mode" is an error)
  *
  *  @return list [ int successful, list failed, list remaining, list srcremaining, list update_messages ]
  * The 'successful' value will be negative, if installation was aborted !
 */
 /* TYPEINFO: list<any>(integer)*/
 YCPValue PkgFunctions::Commit (const YCPMap& config)
+{
+    unsigned pipeline_depth = 0;
+
+    if (!CommitOptions(config, pipeline_depth))
+	return YCPVoid();
+
+    return CommitImpl(pipeline_depth).toYCP();
+}
+
+bool PkgFunctions::CommitOptions(const YCPMap& config, unsigned &pipeline_depth)
 {
     commit_policy = new zypp::ZYppCommitPolicy;
+    pipeline_depth = 0;
 
     if (!config.isNull())
     {
@@ -2367,7 +2391,7 @@ YCPValue PkgFunctions::Commit (const YCPMap& config)
 		    delete commit_policy;
 		    commit_policy = NULL;
 
-                    return YCPVoid();
+                    return false;
                 }
 
                 y2milestone("Using download mode: %s", mode.c_str());
@@ -2380,7 +2404,7 @@ YCPValue PkgFunctions::Commit (const YCPMap& config)
 		delete commit_policy;
 		commit_policy = NULL;
 
-                return YCPVoid();
+                return false;
             }
         }
 
@@ -2403,7 +2427,7 @@ YCPValue PkgFunctions::Commit (const YCPMap& config)
 		delete commit_policy;
 		commit_policy = NULL;
 
-                return YCPVoid();
+                return false;
             }
         }
 
@@ -2426,7 +2450,7 @@ YCPValue PkgFunctions::Commit (const YCPMap& config)
 		delete commit_policy;
 		commit_policy = NULL;
 
-                return YCPVoid();
+                return false;
             }
         }
 
@@ -2449,7 +2473,7 @@ YCPValue PkgFunctions::Commit (const YCPMap& config)
 		delete commit_policy;
 		commit_policy = NULL;
 
-                return YCPVoid();
+                return false;
             }
         }
 
@@ -2472,12 +2496,63 @@ YCPValue PkgFunctions::Commit (const YCPMap& config)
 		delete commit_policy;
 		commit_policy = NULL;
 
-                return YCPVoid();
+                return false;
+            }
+        }
+
+        key = YCPString("pipeline");
+        // download the next packages while installing
+        if(!config->value(key).isNull())
+        {
+            YCPValue depth = YCPNull();
+            if (config->value(key)->isMap())
+                depth = config->value(key)->asMap()->value(YCPString("depth"));
+
+            if (!config->value(YCPString("download_mode")).isNull() && commit_policy->downloadMode() != zypp::DownloadAsNeeded)
+            {
+                y2error("Pipeline option: requires `download_as_needed download mode, got: %s", config->value(YCPString("download_mode"))->toString().c_str());
+                _last_error.setLastError(std::string("Pipeline option conflicts with download mode: ") + config->value(YCPString("download_mode"))->toString());
+
+		delete commit_policy;
+		commit_policy = NULL;
+
+                return false;
+            }
+
+            if (!depth.isNull() && depth->isInteger() && depth->asInteger()->value() > 0)
+            {
+                pipeline_depth = depth->asInteger()->value();
+                // the pipeline downloads the packages in advance
+                commit_policy->downloadMode(zypp::DownloadAsNeeded);
+
+                y2milestone("Using commit pipeline, depth: %u", pipeline_depth);
+            }
+            else
+            {
+                y2error("Pipeline option: $[\"depth\" : <positive integer>] is required, got: %s", config->value(key)->toString().c_str());
+                _last_error.setLastError(std::string("Invalid pipeline option: ") + config->value(key)->toString());
+
+		delete commit_policy;
+		commit_policy = NULL;
+
+                return false;
             }
         }
     }
 
-    YCPValue ret = CommitHelper(commit_policy);
+    return true;
+}
+
+PlainValue PkgFunctions::CommitImpl(unsigned pipeline_depth)
+{
+    if (pipeline_depth > 0 && !commit_policy->dryRun())
+	commit_pipeline = new CommitPipeline(pipeline_depth);
+
+    PlainValue ret = CommitHelper(commit_policy);
+
+    // wait for the running downloads
+    delete commit_pipeline;
+    commit_pipeline = NULL;
 
     delete commit_policy;
     commit_policy = NULL;
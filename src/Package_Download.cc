@@ -0,0 +1,450 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	$Id$
+   Summary:     Downloading the packages in advance
+   Namespace:   Pkg
+*/
+
+#include <PkgFunctions.h>
+#include <PkgProgress.h>
+#include <HelpTexts.h>
+#include "ProcessPool.h"
+#include "CommitPipeline.h"
+#include "FileCopy.h"
+#include "log.h"
+
+#include <ycp/YCPBoolean.h>
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPString.h>
+#include <ycp/YCPMap.h>
+#include <ycp/YCPList.h>
+#include <ycp/YCPVoid.h>
+
+#include <zypp/base/Easy.h>
+#include <zypp/ResPool.h>
+#include <zypp/ZConfig.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+
+#include <map>
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+// the max. number of download processes at once (for all hosts)
+static const unsigned max_prefetch_jobs = 16;
+
+// download the packages into the package cache (in a child process)
+static bool downloadPackages(const std::vector<zypp::Package::constPtr> &packages, long bandwidth)
+{
+    if (bandwidth > 0)
+	zypp::ZConfig::instance().set_download_max_download_speed(bandwidth);
+
+    zypp::repo::RepoMediaAccess access;
+    bool ret = true;
+
+    for (std::vector<zypp::Package::constPtr>::const_iterator it = packages.begin(); it != packages.end(); ++it)
+    {
+	if (!prefetchPackage(*it, access))
+	    ret = false;
+    }
+
+    return ret;
+}
+
+/**
+ * @builtin PrefetchPackages
+ * @short Download the packages to install in advance
+ * @description
+ * Downloads the packages selected to install into the package cache, the following
+ * Commit() finds them there and installs them without downloading. The packages
+ * from the same server are downloaded by several processes at once, each process
+ * downloads a part of the packages. Only the packages from the remote repositories
+ * (HTTP, FTP, ...) are downloaded, the failed packages are downloaded again by Commit().
+ *
+ * Supported options:
+ * "connections" (integer) - the max. number of connections to a server (default: 4),
+ * "bandwidth" (integer) - the max. total download speed in bytes per second (default: 0 = unlimited)
+ *
+ * @param map options
+ * @return map $[ "packages" : integer (number of packages to install), "cached" : integer (already in the cache),
+ *   "downloaded" : integer, "failed" : integer, "skipped" : integer (from a local repository) ], nil on error
+ */
+YCPValue PkgFunctions::PrefetchPackages(const YCPMap& options)
+{
+    unsigned connections = 4;
+    long long bandwidth = 0;
+
+    if (!options.isNull())
+    {
+	const char *key = "connections";
+	if(!options->value(YCPString(key)).isNull())
+	{
+	    const YCPValue val = options->value(YCPString(key));
+	    if (val->isInteger() && val->asInteger()->value() > 0)
+	    {
+		connections = val->asInteger()->value();
+	    }
+	    else
+	    {
+		y2error("Expected positive integer value for '%s' key, found %s", key, val->toString().c_str());
+		return YCPVoid();
+	    }
+	}
+
+	key = "bandwidth";
+	if(!options->value(YCPString(key)).isNull())
+	{
+	    const YCPValue val = options->value(YCPString(key));
+	    if (val->isInteger() && val->asInteger()->value() >= 0)
+	    {
+		bandwidth = val->asInteger()->value();
+	    }
+	    else
+	    {
+		y2error("Expected non-negative integer value for '%s' key, found %s", key, val->toString().c_str());
+		return YCPVoid();
+	    }
+	}
+    }
+
+    long long total = 0, cached = 0, skipped = 0;
+    // host -> packages
+    std::map<std::string, std::vector<zypp::Package::constPtr> > hosts;
+
+    try
+    {
+	zypp::ResPool pool(zypp::ResPool::instance());
+
+	for_(it, pool.byKindBegin<zypp::Package>(), pool.byKindEnd<zypp::Package>())
+	{
+	    if (!it->status().isToBeInstalled())
+		continue;
+
+	    ++total;
+	    zypp::Package::constPtr package = zypp::asKind<zypp::Package>(it->resolvable());
+
+	    if (package->isCached())
+	    {
+		++cached;
+		continue;
+	    }
+
+	    zypp::Url url(package->repoInfo().url());
+
+	    if (!url.schemeIsDownloading())
+	    {
+		++skipped;
+		continue;
+	    }
+
+	    hosts[url.getHost()].push_back(package);
+	}
+    }
+    catch (const zypp::Exception& excpt)
+    {
+	y2error("Cannot read the transaction: %s", excpt.asString().c_str());
+	_last_error.setLastError(ExceptionAsString(excpt));
+	return YCPVoid();
+    }
+
+    // split the packages from each server into at most <connections> parts
+    std::vector<std::vector<zypp::Package::constPtr> > parts;
+
+    for (std::map<std::string, std::vector<zypp::Package::constPtr> >::const_iterator h = hosts.begin(); h != hosts.end(); ++h)
+    {
+	size_t count = std::min<size_t>(connections, h->second.size());
+	size_t first = parts.size();
+	parts.resize(first + count);
+
+	for (size_t i = 0; i < h->second.size(); ++i)
+	    parts[first + i % count].push_back(h->second[i]);
+
+	y2milestone("Prefetching %zu packages from %s using %zu connections", h->second.size(), h->first.c_str(), count);
+    }
+
+    long long downloaded = 0, failed = 0;
+
+    if (!parts.empty())
+    {
+	ProcessPool jobs(max_prefetch_jobs);
+	// each running process gets the same part of the bandwidth
+	long part_bandwidth = bandwidth > 0 ? std::max<long long>(1, bandwidth / std::min<size_t>(parts.size(), max_prefetch_jobs)) : 0;
+
+	for (size_t i = 0; i < parts.size(); ++i)
+	{
+	    const std::vector<zypp::Package::constPtr> &part(parts[i]);
+	    jobs.add(part.front()->repoInfo().alias(), [&part, part_bandwidth] {
+		return downloadPackages(part, part_bandwidth);
+	    });
+	}
+
+	PkgProgress pkgprogress(_callbackHandler);
+	std::list<std::string> stages;
+	stages.push_back(_("Download Packages"));
+
+	zypp::ProgressData prog_total(total - cached - skipped);
+	prog_total.sendTo(pkgprogress.Receiver());
+	pkgprogress.Start(_("Downloading Packages..."), stages, _(HelpTexts::prefetch_help));
+
+	jobs.run([&](size_t index, ProcessPool::Result) {
+	    // the progress callback returns false on abort
+	    return prog_total.incr(parts[index].size());
+	});
+
+	pkgprogress.Done();
+
+	// the failed part might be partly downloaded, check the cache
+	for (size_t i = 0; i < parts.size(); ++i)
+	{
+	    for (std::vector<zypp::Package::constPtr>::const_iterator it = parts[i].begin(); it != parts[i].end(); ++it)
+	    {
+		if ((*it)->isCached())
+		    ++downloaded;
+		else
+		    ++failed;
+	    }
+	}
+    }
+
+    y2milestone("Prefetched packages: %lld total, %lld cached, %lld downloaded, %lld failed, %lld skipped",
+	total, cached, downloaded, failed, skipped);
+
+    YCPMap ret;
+    ret->add(YCPString("packages"), YCPInteger(total));
+    ret->add(YCPString("cached"), YCPInteger(cached));
+    ret->add(YCPString("downloaded"), YCPInteger(downloaded));
+    ret->add(YCPString("failed"), YCPInteger(failed));
+    ret->add(YCPString("skipped"), YCPInteger(skipped));
+
+    return ret;
+}
+
+// put the package file into the directory, returns the used method ("hardlink" or "copy"), empty on error
+static std::string exportFile(const zypp::Pathname &file, const zypp::Pathname &dir, bool hardlink, std::string &error)
+{
+    zypp::Pathname target(dir / file.basename());
+
+    // the target is the cached file itself (e.g. exporting into the package cache),
+    // replacing it would delete the only copy
+    struct stat source_st, target_st;
+    if (::stat(file.c_str(), &source_st) == 0 && ::stat(target.c_str(), &target_st) == 0
+	&& source_st.st_dev == target_st.st_dev && source_st.st_ino == target_st.st_ino)
+	return "hardlink";
+
+    // create the file in a temporary directory and rename it over the target,
+    // the old target is kept if anything fails
+    zypp::filesystem::TmpDir tmpdir(dir, ".export.");
+    if (tmpdir.path().empty())
+    {
+	error = "Cannot create a temporary directory in " + dir.asString();
+	return std::string();
+    }
+
+    zypp::Pathname tmp(tmpdir.path() / file.basename());
+    std::string method;
+
+    if (hardlink && ::link(file.c_str(), tmp.c_str()) == 0)
+	method = "hardlink";
+    // reflink if supported, copy otherwise
+    else if (copyTree(file.asString(), tmpdir.path().asString(), false, error))
+	method = "copy";
+    else
+	return std::string();
+
+    if (::rename(tmp.c_str(), target.c_str()) != 0)
+    {
+	error = "Cannot rename " + tmp.asString() + " to " + target.asString() + ": " + ::strerror(errno);
+	return std::string();
+    }
+
+    return method;
+}
+
+/**
+ * @builtin ProvidePackages
+ * @short Export packages from a repository to a directory
+ * @description
+ * Puts the packages from the repository into the directory (e.g. for creating an offline medium).
+ * The packages missing in the package cache are downloaded in parallel (by several processes),
+ * the packages are hardlinked from the cache when possible, otherwise copied (using reflinks
+ * when the filesystem supports them).
+ *
+ * Supported options:
+ * "parallel" (integer) - the max. number of parallel downloads (default: 4),
+ * "hardlink" (boolean) - hardlink the cached packages (default: true), false = always copy
+ *
+ * @param integer repo_id repository ID
+ * @param list<string> names package names
+ * @param string dir target directory (created if missing)
+ * @param map options
+ * @return map $[ "name" : $[ "path" : string, "method" : "hardlink"|"copy" ], "name2" : $[ "error" : string ], ... ],
+ *   nil on error
+ */
+YCPValue PkgFunctions::ProvidePackages(const YCPInteger& repo_id, const YCPList& names, const YCPString& dir, const YCPMap& options)
+{
+    if (repo_id.isNull() || names.isNull() || dir.isNull() || dir->value().empty())
+    {
+	y2error("Missing argument");
+	return YCPVoid();
+    }
+
+    unsigned parallel = 4;
+    bool hardlink = true;
+
+    if (!options.isNull())
+    {
+	const char *key = "parallel";
+	if(!options->value(YCPString(key)).isNull())
+	{
+	    const YCPValue val = options->value(YCPString(key));
+	    if (val->isInteger() && val->asInteger()->value() > 0)
+	    {
+		parallel = val->asInteger()->value();
+	    }
+	    else
+	    {
+		y2error("Expected positive integer value for '%s' key, found %s", key, val->toString().c_str());
+		return YCPVoid();
+	    }
+	}
+
+	key = "hardlink";
+	if(!options->value(YCPString(key)).isNull())
+	{
+	    const YCPValue val = options->value(YCPString(key));
+	    if (val->isBoolean())
+	    {
+		hardlink = val->asBoolean()->value();
+	    }
+	    else
+	    {
+		y2error("Expected boolean value for '%s' key, found %s", key, val->toString().c_str());
+		return YCPVoid();
+	    }
+	}
+    }
+
+    if (!logFindRepository(repo_id->value()))
+	return YCPVoid();
+
+    zypp::Pathname target(dir->value());
+
+    if (zypp::filesystem::assert_dir(target) != 0)
+    {
+	y2error("Cannot create directory %s", target.c_str());
+	_last_error.setLastError(_("Cannot create directory ") + target.asString());
+	return YCPVoid();
+    }
+
+    YCPMap ret;
+    std::vector<std::pair<std::string, zypp::Package::constPtr> > packages;
+    std::vector<zypp::Package::constPtr> to_download;
+
+    for (int i = 0; i < names->size(); ++i)
+    {
+	if (!names->value(i)->isString())
+	{
+	    y2error("Invalid package name: %s", names->value(i)->toString().c_str());
+	    continue;
+	}
+
+	YCPString name(names->value(i)->asString());
+	zypp::Package::constPtr package = packageFromRepo(repo_id, name);
+
+	if (!package)
+	{
+	    YCPMap result;
+	    result->add(YCPString("error"), YCPString(_("Package not found")));
+	    ret->add(name, result);
+	    continue;
+	}
+
+	packages.push_back(std::make_pair(name->value(), package));
+
+	if (!package->isCached() && package->repoInfo().url().schemeIsDownloading())
+	    to_download.push_back(package);
+    }
+
+    // download the missing packages into the cache in parallel
+    if (to_download.size() > 1 && parallel > 1)
+    {
+	size_t count = std::min<size_t>(parallel, to_download.size());
+	std::vector<std::vector<zypp::Package::constPtr> > parts(count);
+
+	for (size_t i = 0; i < to_download.size(); ++i)
+	    parts[i % count].push_back(to_download[i]);
+
+	y2milestone("Downloading %zu packages using %zu processes", to_download.size(), count);
+
+	ProcessPool jobs(count);
+
+	for (size_t i = 0; i < parts.size(); ++i)
+	{
+	    const std::vector<zypp::Package::constPtr> &part(parts[i]);
+	    jobs.add(part.front()->name(), [&part] { return downloadPackages(part, 0); });
+	}
+
+	// the failed packages are downloaded again below
+	jobs.run();
+    }
+
+    zypp::repo::RepoMediaAccess access;
+    zypp::repo::PackageProviderPolicy policy;
+    zypp::repo::DeltaCandidates deltas;
+
+    // the cached packages are provided from the cache, the rest is downloaded now
+    for (std::vector<std::pair<std::string, zypp::Package::constPtr> >::const_iterator it = packages.begin(); it != packages.end(); ++it)
+    {
+	YCPMap result;
+
+	try
+	{
+	    zypp::repo::PackageProvider provider(access, it->second, deltas, policy);
+	    zypp::ManagedFile file(provider.providePackage());
+
+	    std::string error;
+	    std::string method(exportFile(file.value(), target, hardlink, error));
+
+	    if (method.empty())
+	    {
+		result->add(YCPString("error"), YCPString(error));
+	    }
+	    else
+	    {
+		result->add(YCPString("path"), YCPString((target / file.value().basename()).asString()));
+		result->add(YCPString("method"), YCPString(method));
+	    }
+	}
+	catch (const zypp::Exception& excpt)
+	{
+	    y2error("Package %s could not be downloaded: %s", it->first.c_str(), excpt.asString().c_str());
+	    result->add(YCPString("error"), YCPString(ExceptionAsString(excpt)));
+	}
+
+	ret->add(YCPString(it->first), result);
+    }
+
+    return ret;
+}
@@ -28,6 +28,7 @@
 #include "log.h"
 
 #include "Callbacks.h"
+#include "CallStats.h"
 
 #include <ycp/YCPInteger.h>
 #include <ycp/YCPString.h>
@@ -65,9 +66,13 @@ PkgFunctions::PkgFunctions () :
     , repo_manager(NULL)
     , autorefresh_skipped(false)
     , current_repo(-1LL)
+    , metadata_status_memo(false)
     , commit_policy(NULL)
+    , commit_pipeline(NULL)
     ,_callbackHandler( *new CallbackHandler(*this) )
     , base_product(NULL)
+    , async_last_id(0LL)
+    , builtin_depth(0)
 {
     const char *domain = "pkg-bindings";
     bindtextdomain( domain, LOCALEDIR );
@@ -139,8 +144,15 @@ zypp::ZYpp::Ptr PkgFunctions::zypp_ptr()
  */
 PkgFunctions::~PkgFunctions ()
 {
+    // stop the async operations before removing the callbacks
+    for (AsyncOperations::iterator it = async_operations.begin(); it != async_operations.end(); ++it)
+	delete it->second;
+    async_operations.clear();
+
     delete &_callbackHandler;
 
+    JoinRepoCleanup();
+
     if (base_product)
     {
         delete base_product;
@@ -229,6 +241,30 @@ zypp::RepoManager* PkgFunctions::CreateRepoManager()
     return repo_manager;
 }
 
+zypp::RepoManager* PkgFunctions::ReloadRepoManager()
+{
+    y2milestone("Reloading the repository manager");
+
+    if (repo_manager) delete repo_manager;
+    repo_manager = new zypp::RepoManager(GetRepoManagerOptions(_target_root, repo_target_distro));
+
+    return repo_manager;
+}
+
+zypp::RepoManagerOptions PkgFunctions::GetRepoManagerOptions(const std::string& root, const std::string& target_distro) const
+{
+    zypp::RepoManagerOptions repo_manager_options(root);
+
+    if (!target_distro.empty())
+    {
+        // override the target distribution autodetection
+        y2milestone("Using target_distro: %s", target_distro.c_str());
+        repo_manager_options.servicesTargetDistro = target_distro;
+    }
+
+    return repo_manager_options;
+}
+
 // convert Exception object to string represenatation
 std::string PkgFunctions::ExceptionAsString(const zypp::Exception &e)
 {
@@ -260,6 +296,18 @@ void PkgFunctions::SetReportedSource(RepoId repo, int medium)
     last_reported_mediumnr = medium;
 }
 
+void PkgFunctions::CommitInstalling(const zypp::sat::Solvable &solvable)
+{
+    if (commit_pipeline)
+	commit_pipeline->installing(solvable);
+}
+
+void PkgFunctions::CommitInstalled(const zypp::sat::Solvable &solvable)
+{
+    if (commit_pipeline)
+	commit_pipeline->installed(solvable);
+}
+
 /**
  * @builtin ZConfig
  * @short get the current libzypp configuration
@@ -430,25 +478,17 @@ YCPValue PkgFunctions::SetZConfig(const YCPMap &cfg)
     return YCPBoolean(true);
 }
 
-bool PkgFunctions::RepoManagerUpdateTarget(const std::string& root, const YCPMap& options)
+bool PkgFunctions::RepoManagerUpdateTarget(const std::string& root, const std::string& target_distro)
 {
     bool new_target = _target_root != root;
 
     // a repository manager is present and the target has been changed
     // or the repo manager options changed
-    if ((repo_manager && new_target) || options.compare(repo_options) != YO_EQUAL)
+    if ((repo_manager && new_target) || target_distro != repo_target_distro)
     {
         y2milestone("Updating RepoManager (target changed from %s to %s)", _target_root.c_str(), root.c_str());
 
-        zypp::RepoManagerOptions repo_manager_options(root);
-
-        y2debug("repomanager options size: %zd", options.size());
-        if(!options->value(YCPString("target_distro")).isNull() && options->value(YCPString("target_distro"))->isString())
-        {
-            // override the target distribution autodetection
-            y2milestone("Using target_distro: %s", options->value(YCPString("target_distro"))->asString()->value().c_str());
-            repo_manager_options.servicesTargetDistro = options->value(YCPString("target_distro"))->asString()->value();
-        }
+        zypp::RepoManagerOptions repo_manager_options(GetRepoManagerOptions(root, target_distro));
 
         // repository manager options cannot be replaced, a new repository manager is needed
         zypp::RepoManager* new_repo_manager = new zypp::RepoManager(repo_manager_options);
@@ -472,12 +512,16 @@ bool PkgFunctions::RepoManagerUpdateTarget(const std::string& root, const YCPMap
         repo_manager = new_repo_manager;
 
         // remember the repo options for the next time
-        repo_options = options;
+        repo_target_distro = target_distro;
     }
 
     // update package cache path for loaded repositories when changing the target
     if (new_target)
     {
+        // the repositories have not been saved in the new target yet
+        for (RepoCont::iterator it = repos.begin(); it != repos.end(); ++it)
+            (*it)->setDirty();
+
         zypp::RepoManagerOptions repo_options(root);
         zypp::Pathname packages_prefix = repo_options.repoPackagesCachePath;
 
@@ -498,9 +542,9 @@ bool PkgFunctions::RepoManagerUpdateTarget(const std::string& root, const YCPMap
     return new_target;
 }
 
-bool PkgFunctions::SetTarget(const std::string &root, const YCPMap& options)
+bool PkgFunctions::SetTarget(const std::string &root, const std::string& target_distro)
 {
-    bool new_target = RepoManagerUpdateTarget(root, options);
+    bool new_target = RepoManagerUpdateTarget(root, target_distro);
     _target_root = root;
 
     return new_target;
@@ -553,6 +597,36 @@ zypp::Url PkgFunctions::ExpandedUrl(const zypp::Url& url) const
     return replacedUrl.transformed();
 }
 
+/**
+ * @builtin BuiltinStats
+ * @short Statistics of the called Pkg builtins
+ * @description
+ * Returns the number of calls and the time spent in each Pkg builtin since
+ * the start (or since the last BuiltinStatsReset() call). The times are in microseconds,
+ * the percentiles are approximate (the relative error is up to 12.5%).
+ * The time includes the time spent in the YCP callbacks.
+ *
+ * Set the Y2PKG_BUILTIN_STATS environment variable to a file name to write
+ * the statistics to that file at exit.
+ *
+ * @return map $[ "SourceLoad" : $[ "count" : 1, "total" : 1520000, "max" : 1520000, "p50" : 1520000, "p99" : 1520000 ], ...]
+ */
+YCPValue PkgFunctions::BuiltinStats()
+{
+    return CallStats::instance().asYCPMap();
+}
+
+/**
+ * @builtin BuiltinStatsReset
+ * @short Reset the builtin statistics
+ * @return void
+ */
+YCPValue PkgFunctions::BuiltinStatsReset()
+{
+    CallStats::instance().reset();
+    return YCPVoid();
+}
+
 
 /**
  * @builtin CompareVersions
@@ -29,6 +29,9 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
+#include <thread>
 
 #include <ycp/YCPMap.h>
 
@@ -56,9 +59,16 @@ class YCPReference;
 
 #include "ServiceManager.h"
 #include "BaseProduct.h"
+#include "LoadStats.h"
+#include "DownloadArea.h"
+#include "CommitPipeline.h"
+#include "TransferStats.h"
+#include "MirrorRank.h"
+#include "PlainValue.h"
 
 #include "PkgError.h"
 class PkgProgress;
+class AsyncOperation;
 
 namespace zypp
 {
@@ -129,15 +139,16 @@ class PkgFunctions
       RepoId last_reported_repo;
       int last_reported_mediumnr;
 
-      YCPValue SourceRefreshHelper(const YCPInteger &id, bool forced = false);
-      YCPValue ServiceRefreshHelper(const YCPString &alias, bool forced = false);
+      // the YCP values are not used here, can be called in an async operation
+      bool SourceRefreshHelper(RepoId id, bool forced = false);
+      bool ServiceRefreshHelper(const std::string &alias, bool forced = false);
 
       // helper for updating repository manager after changing the target root
       // return true if the target root has been changed
-      bool RepoManagerUpdateTarget(const std::string& root, const YCPMap& options = YCPMap());
+      bool RepoManagerUpdateTarget(const std::string& root, const std::string& target_distro = std::string());
 
       // set new target directory
-      bool SetTarget(const std::string &root, const YCPMap& options = YCPMap());
+      bool SetTarget(const std::string &root, const std::string& target_distro = std::string());
 
       // configured or default download area
       zypp::Pathname download_area_path();
@@ -155,7 +166,7 @@ class PkgFunctions
       // helper - create a directory if it doesn't exist
       bool CreateDir(const std::string &path);
       // helper - copy a file or directory
-      bool CopyToDir(const std::string &source, const std::string &target, bool backup = false, bool recursive = true);
+      bool CopyToDir(const std::string &source, const std::string &target, bool backup = false);
 
       void RemoveResolvablesFrom(YRepo_Ptr repo);
       bool LoadResolvablesFrom(YRepo_Ptr repo, const zypp::ProgressData::ReceiverFnc & progressrcv = zypp::ProgressData::ReceiverFnc(), bool network_check = false);
@@ -174,6 +185,12 @@ class PkgFunctions
 
       zypp::RepoManager* CreateRepoManager();
 
+      // create a new repository manager (with the current options), needed after
+      // the repositories or services have been changed on disk by another process
+      zypp::RepoManager* ReloadRepoManager();
+
+      zypp::RepoManagerOptions GetRepoManagerOptions(const std::string& root, const std::string& target_distro) const;
+
       void SetCurrentDU();
 
       // callback related funcions
@@ -195,7 +212,101 @@ class PkgFunctions
 	const YCPString& d, const YCPBoolean &optional,
 	const YCPBoolean &recursive, bool check_signatures);
 
-      YCPValue SourceLoadImpl(PkgProgress &progress);
+      // the YCP values are not used here, can be called in an async operation
+      bool SourceLoadImpl(PkgProgress &progress);
+      bool SourceLoadInternal();
+      // "error" is set to the exception message on failure
+      bool TargetInitializeImpl(const std::string &root, const std::string &target_distro, std::string *error = NULL);
+      bool TargetLoadImpl(std::string *error = NULL);
+      bool SourceReleaseAllImpl();
+
+      // removing the data of the deleted repositories in background
+      std::thread repo_cleanup;
+      // wait until the data of the deleted repositories are removed
+      void JoinRepoCleanup();
+
+      // options for SourceLoad, see SourceLoadOptions()
+      struct LoadOptions
+      {
+	  LoadOptions() : parallel_refresh(1), parallel_build(0), pipeline(true),
+	    skip_srcpackages(false), skip_debuginfo(false), rank_mirrors(false) {}
+
+	  // max. number of repositories refreshed at once, opt-in: the forked refresh
+	  // cannot ask the user (authentication, GPG keys), the callers must enable it
+	  unsigned parallel_refresh;
+	  // max. number of caches built at once, 0 = use the number of CPUs
+	  // (limited by the available memory)
+	  unsigned parallel_build;
+	  // load the repositories as soon as they are refreshed and their cache is built
+	  bool pipeline;
+	  // do not load the source and the debuginfo repositories (save memory)
+	  bool skip_srcpackages;
+	  bool skip_debuginfo;
+	  // try the nearest server first (for the repositories with several base URLs)
+	  bool rank_mirrors;
+      };
+
+      LoadOptions load_options;
+
+      // the latencies of the servers, see RankMirrors()
+      MirrorRank mirror_rank;
+
+      // order the base URLs of the enabled repositories by the server latency
+      void RankMirrors();
+
+      // statistics of the last SourceLoad, see SourceLoadStats()
+      LoadStats load_stats;
+
+      // metadata status of the repositories (alias -> status), memoized
+      // during SourceLoad (computing the status reads the whole raw metadata)
+      std::map<std::string, zypp::RepoStatus> metadata_status;
+      bool metadata_status_memo;
+
+      // start memoizing the metadata status
+      void MemoizeMetadataStatus();
+      // stop memoizing the metadata status
+      void ClearMetadataStatus();
+      // the (memoized) metadata status of the repository
+      zypp::RepoStatus MetadataStatus(const zypp::RepoInfo &repo);
+      // the metadata of the repository have been changed (refreshed)
+      void InvalidateMetadataStatus(const std::string &alias);
+
+      // update the metadata status and the statistics
+      // after the repository has been refreshed in a forked process
+      void RefreshedInChild(const zypp::RepoInfo &repo, double duration, long long downloaded);
+
+      // refresh the remote repositories in parallel (in forked processes),
+      // the successfully refreshed repositories are added to "refreshed", the failed
+      // ones to "failed" (they are not refreshed again), returns true if the refresh
+      // has been started (CallRefreshStarted() called)
+      bool RefreshParallel(zypp::ProgressData &prog_total, RepoCont &refreshed, RepoCont &failed);
+
+      // the refresh in a forked process has failed, report the error
+      void RefreshFailedInChild(const zypp::RepoInfo &repo, const std::string &error);
+
+      // is the repository enabled, not deleted and not skipped by the load options?
+      bool LoadEnabled(const YRepo_Ptr &repo) const;
+
+      // the remote repositories which can be refreshed in a forked process
+      RepoCont RefreshCandidates();
+
+      // refresh the remote repositories and build their caches in parallel,
+      // the finished repositories are loaded into the pool (in the "repos" order)
+      // while the rest is still being processed, the loaded repositories (or failed
+      // to load, the error is reported and "success" is set to false) are added
+      // to "loaded", the refreshed repositories which have to wait for a previous
+      // repository to keep the order to "prepared" (loaded later), the repositories
+      // which failed to refresh to "failed", returns true if CallRefreshStarted() has been called
+      bool LoadPipeline(zypp::ProgressData &prog_total, RepoCont &loaded, RepoCont &prepared, RepoCont &failed, bool &success);
+
+      // build the solv caches in parallel (in forked processes),
+      // the successfully built repositories are added to "built"
+      void BuildCacheParallel(zypp::ProgressData &prog_total, RepoCont &built);
+
+      // refresh the services in parallel (in forked processes), the successfully
+      // refreshed services are added to "refreshed" and reloaded from disk, the failed
+      // ones (with the error reported) to "failed", returns false if a refresh failed
+      bool RefreshServicesParallel(const ServiceManager::Services &services, std::set<std::string> &refreshed, std::set<std::string> &failed);
       YCPValue SourceStartManagerImpl(const YCPBoolean& enable, PkgProgress &progress);
 
       // After all, APPL_HIGH might be more appropriate, because we suggest
@@ -220,6 +331,9 @@ class PkgFunctions
       // CommitPolicy used for commit
       zypp::ZYppCommitPolicy *commit_policy;
 
+      // downloads the next packages during commit (the "pipeline" Commit option)
+      CommitPipeline *commit_pipeline;
+
       // getPackageFromRepo used for PkgFunctions::ProvidePackage
       zypp::Package::constPtr packageFromRepo(const YCPInteger & repo_id, const YCPString & name);
     private:
@@ -236,9 +350,30 @@ class PkgFunctions
 
       BaseProduct* base_product;
 
-      std::vector<zypp::filesystem::TmpDir> tmp_dirs;
+      // the provided files and the cache of the digested files (the Fetcher
+      // copies (hardlinks) a cached file when its checksum matches)
+      DownloadArea download_area;
 
-      YCPMap repo_options;
+      // the download statistics (updated by the download callbacks)
+      TransferStats transfer_stats;
+
+      // the cache directory for the repository medium
+      zypp::Pathname ProvideCachePath(const YRepo_Ptr &repo, unsigned medium);
+      // remember a downloaded file (hardlink it into the cache)
+      void ProvideCacheStore(const zypp::Pathname &cache, const zypp::Pathname &dir, const std::string &file);
+
+      // the started asynchronous operations (see StartAsync)
+      typedef std::map<long long, AsyncOperation*> AsyncOperations;
+      AsyncOperations async_operations;
+      long long async_last_id;
+
+      AsyncOperation* findAsyncOperation(const YCPInteger &handle);
+
+      // the target distribution set by TargetInitializeOptions() (empty = autodetect)
+      std::string repo_target_distro;
+
+      // the number of the running builtins (> 1 when a builtin is called from a YCP callback)
+      unsigned builtin_depth;
 
       /**
        * Logging helper:
@@ -306,6 +441,10 @@ class PkgFunctions
 	YCPValue ExpandedName(const YCPString&) const;
 	/* TYPEINFO: string(string)*/
 	YCPValue ExpandedUrl (const YCPString&);
+	/* TYPEINFO: map<string,map<string,integer>>() */
+	YCPValue BuiltinStats ();
+	/* TYPEINFO: void() */
+	YCPValue BuiltinStatsReset ();
 
 	// callbacks
 	/* TYPEINFO: void(void(string,integer,boolean)) */
@@ -495,6 +634,11 @@ class PkgFunctions
 	/* TYPEINFO: void(void()) */
 	YCPValue CallbackProcessDone( const YCPValue& /*nil*/ args );
 
+	/* TYPEINFO: void(boolean(list<map<string,any>>)) */
+	YCPValue CallbackEventBatch( const YCPValue& /*nil*/ args );
+	/* TYPEINFO: void(integer) */
+	YCPValue SetCallbackEventBatchInterval( const YCPInteger& interval );
+
 	// source related
 	/* TYPEINFO: boolean(boolean)*/
         YCPValue SourceStartManager (const YCPBoolean&);
@@ -502,6 +646,12 @@ class PkgFunctions
 	YCPValue SourceRestore();
 	/* TYPEINFO: boolean()*/
 	YCPValue SourceLoad();
+	/* TYPEINFO: boolean(map<string,any>)*/
+	YCPValue SourceLoadOptions(const YCPMap &options);
+	/* TYPEINFO: map<string,map<string,integer>>()*/
+	YCPValue SourceLoadStats();
+	/* TYPEINFO: map<string,any>()*/
+	YCPValue PoolStats();
 	/* TYPEINFO: integer(string,string)*/
 	YCPValue SourceCreate (const YCPString&, const YCPString&);
 	/* TYPEINFO: integer(string,string)*/
@@ -539,6 +689,16 @@ class PkgFunctions
 	YCPValue SourceProvideSignedFile(const YCPInteger& id, const YCPInteger& mid, const YCPString& f, const YCPBoolean &optional);
 	/* TYPEINFO: string(integer,integer,string,boolean)*/
 	YCPValue SourceProvideDigestedFile(const YCPInteger& id, const YCPInteger& mid, const YCPString& f, const YCPBoolean &optional);
+	/* TYPEINFO: map<string,map<string,string>>(integer,integer,list<string>,map<string,any>)*/
+	YCPValue SourceProvideFiles(const YCPInteger& id, const YCPInteger& mid, const YCPList& files, const YCPMap& options);
+	/* TYPEINFO: map<string,integer>()*/
+	YCPValue DownloadAreaStats();
+	/* TYPEINFO: map<string,map<string,map<string,integer>>>()*/
+	YCPValue DownloadStats();
+	/* TYPEINFO: boolean(integer)*/
+	YCPValue SetDownloadAreaLimit(const YCPInteger& limit);
+	/* TYPEINFO: boolean(string,boolean)*/
+	YCPValue DownloadAreaPin(const YCPString& path, const YCPBoolean& pin);
 	/* TYPEINFO: boolean(string)*/
 	YCPValue SourceCacheCopyTo (const YCPString&);
 	/* TYPEINFO: boolean(integer,boolean)*/
@@ -583,6 +743,8 @@ class PkgFunctions
         YCPValue TargetInitializeOptions (const YCPString& root, const YCPMap& options);
         /* TYPEINFO: boolean()*/
         YCPValue TargetLoad ();
+        /* TYPEINFO: boolean(string, map<any,any>)*/
+        YCPValue StartManagerAndTarget (const YCPString& root, const YCPMap& options);
 	/* TYPEINFO: boolean()*/
 	YCPBoolean TargetDisableSources ();
 	/* TYPEINFO: boolean()*/
@@ -682,6 +844,10 @@ class PkgFunctions
 	YCPValue PkgApplReset ();
         /* TYPEINFO: boolean(integer,string,string) */
 	YCPValue ProvidePackage(const YCPInteger & repo_id, const YCPString & name, const YCPString & path);
+	/* TYPEINFO: map<string,integer>(map<string,any>)*/
+	YCPValue PrefetchPackages(const YCPMap& options);
+	/* TYPEINFO: map<string,map<string,string>>(integer,list<string>,string,map<string,any>)*/
+	YCPValue ProvidePackages(const YCPInteger& repo_id, const YCPList& names, const YCPString& dir, const YCPMap& options);
 	/* TYPEINFO: map<string,any>()*/
 	YCPValue GetSolverFlags();
 	/* TYPEINFO: boolean(map<string,any>)*/
@@ -694,7 +860,11 @@ class PkgFunctions
 	YCPBoolean PkgSolveCheckTargetOnly ();
 	/* TYPEINFO: integer()*/
 	YCPValue PkgSolveErrors ();
-        YCPValue CommitHelper(const zypp::ZYppCommitPolicy *policy);
+        // the YCP values are not used here, can be called in an async operation
+        PlainValue CommitHelper(const zypp::ZYppCommitPolicy *policy);
+        PlainValue CommitImpl(unsigned pipeline_depth);
+        // set commit_policy according to the Commit() config
+        bool CommitOptions(const YCPMap& config, unsigned &pipeline_depth);
 	/* TYPEINFO: list<any>(integer)*/
 	YCPValue PkgCommit (const YCPInteger& medianr);
 	/* TYPEINFO: list<any>(map<string,any>)*/
@@ -834,6 +1004,16 @@ class PkgFunctions
   /* TYPEINFO: integer(string, string) */
   YCPInteger CompareVersions(const YCPString& ver1, const YCPString& ver2);
 
+	// asynchronous operations
+	/* TYPEINFO: integer(symbol,list<any>) */
+	YCPValue StartAsync(const YCPSymbol& operation, const YCPList& args);
+	/* TYPEINFO: map<string,any>(integer) */
+	YCPValue AsyncPoll(const YCPInteger& handle);
+	/* TYPEINFO: boolean(integer,integer) */
+	YCPValue AsyncWait(const YCPInteger& handle, const YCPInteger& timeout);
+	/* TYPEINFO: boolean(integer) */
+	YCPValue AsyncCancel(const YCPInteger& handle);
+
 	/**
 	 * Constructor.
 	 */
@@ -851,6 +1031,29 @@ class PkgFunctions
 	int LastReportedMedium() const;
 	void SetReportedSource(RepoId repo, int medium);
 
+	// a package installation has been started/finished (used by the commit pipeline)
+	void CommitInstalling(const zypp::sat::Solvable &solvable);
+	void CommitInstalled(const zypp::sat::Solvable &solvable);
+
+	// the download statistics, see DownloadStats()
+	TransferStats& transferStats() { return transfer_stats; }
+
+	// the alias of the repository containing the URL (empty if not found)
+	std::string AliasForUrl(const zypp::Url &url) const;
+
+	// deliver the queued progress events (see CallbackEventBatch)
+	void FlushCallbackEvents();
+
+	// a builtin is started/finished, BuiltinStarted() returns the nesting
+	// depth (1 = the outermost builtin, not called from a callback)
+	unsigned BuiltinStarted() { return ++builtin_depth; }
+	void BuiltinFinished() { --builtin_depth; }
+
+	// wait until the running async operation is finished, libzypp
+	// and the Pkg state must not be used concurrently (except the callbacks
+	// evaluated for the operation)
+	void AsyncWaitIdle(const std::string &builtin);
+
     string ExpandedName(const string&) const;
     zypp::Url ExpandedUrl(const zypp::Url&) const;
 
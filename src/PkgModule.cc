@@ -22,6 +22,7 @@
 
 #include <PkgModule.h>
 #include "log.h"
+#include "AsyncLogWriter.h"
 
 #include <zypp/base/Logger.h>
 #include <zypp/base/LogControl.h>
@@ -35,7 +36,8 @@ struct YaSTZyppLogger : public zypp::base::LogControl::LineWriter
     // don't log empty (debug) messages  
     if (!formated_r.empty())
     {
-	y2lograw((formated_r+"\n").c_str());
+	// write it from a separate thread, do not block the caller on the log I/O
+	AsyncLogWriter::instance().write(formated_r);
     }
   }
 };
@@ -49,7 +51,9 @@ struct YaSTZyppFormatter : public zypp::base::LogControl::LineFormater
 	    int                 line_r,
 	    const std::string & message_r )
     {
-	if (get_log_debug() || level_r > zypp::base::logger::E_DBG)
+	// check the level first, do not format the debug messages at all
+	// when they are not going to be logged
+	if (level_r > zypp::base::logger::E_DBG || get_log_debug())
 	{
 	    // call the default implementation
 	    return zypp::base::LogControl::LineFormater::format(group_r, level_r, file_r, func_r, line_r, message_r);
@@ -67,6 +71,9 @@ PkgModule* PkgModule::instance ()
     {
 	y2milestone("Redirecting ZYPP log to y2log");
 
+	// create the writer in the main thread, it is used also for logging from the other threads
+	AsyncLogWriter::instance();
+
         boost::shared_ptr<YaSTZyppLogger> myLogger( new YaSTZyppLogger );
         zypp::base::LogControl::instance().setLineWriter( myLogger );
 
@@ -101,5 +108,8 @@ void PkgModule::destroy()
 	y2debug("Deleting PkgModule object...");
 	delete current_pkg;
 	current_pkg = NULL;
+
+	// write the pending ZYPP log
+	AsyncLogWriter::instance().flush();
     }
 }
@@ -3,39 +3,40 @@
 #include "PkgProgress.h"
 #include "log.h"
 
-#include <y2/Y2Function.h>
+#include "PlainValue.h"
 
 void PkgProgress::Start( const std::string &process, const std::list<std::string> &stages,
     const std::string &help)
 {
     if (!running)
     {
-	// get the YCP callback handler for destroy event
-	Y2Function* ycp_handler = callback_handler._ycpCallbacks.createCallback(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessStart);
+	// deliver the pending progress events first
+	callback_handler._ycpCallbacks.flushEvents();
 
 	y2debug("ProcessStart");
 
 	// is the callback registered?
-	if (ycp_handler != NULL)
+	if (callback_handler._ycpCallbacks.isSet(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessStart))
 	{
 	    y2debug("Evaluating ProcessStart callback...");
-	    ycp_handler->appendParameter(YCPString(process));
+	    PlainValue args(PlainValue::list());
+	    args.add(PlainValue::string(process));
 
 	    // create list of stages
-	    YCPList lst;
+	    PlainValue lst(PlainValue::list());
 
 	    for(std::list<std::string>::const_iterator it = stages.begin();
 		it != stages.end() ; ++it )
 	    {
-		lst->add(YCPString(*it) );
+		lst.add(PlainValue::string(*it));
 	    }
 
-	    ycp_handler->appendParameter(lst);
+	    args.add(lst);
 
-	    ycp_handler->appendParameter(YCPString(help));
+	    args.add(PlainValue::string(help));
 
 	    // evaluate the callback function
-	    ycp_handler->evaluateCall();
+	    callback_handler._ycpCallbacks.call(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessStart, args);
 	}
 
 	running = true;
@@ -57,15 +58,15 @@ void PkgProgress::NextStage()
 {
     if (running)
     {
-	// get the YCP callback handler for destroy event
-	Y2Function* ycp_handler = callback_handler._ycpCallbacks.createCallback(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessNextStage);
+	// deliver the pending progress events first
+	callback_handler._ycpCallbacks.flushEvents();
 
 	// is the callback registered?
-	if (ycp_handler != NULL)
+	if (callback_handler._ycpCallbacks.isSet(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessNextStage))
 	{
 	    y2debug("Evaluating NextStage callback...");
 	    // evaluate the callback function
-	    ycp_handler->evaluateCall();
+	    callback_handler._ycpCallbacks.call(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessNextStage);
 	}
     }
 }
@@ -75,46 +76,63 @@ void PkgProgress::Done()
     if (running)
     {
 	y2debug("ProcessDone");
-	// get the YCP callback handler for destroy event
-	Y2Function* ycp_handler = callback_handler._ycpCallbacks.createCallback(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessFinished);
+	// deliver the pending progress events first
+	callback_handler._ycpCallbacks.flushEvents();
 
 	// is the callback registered?
-	if (ycp_handler != NULL)
+	if (callback_handler._ycpCallbacks.isSet(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessFinished))
 	{
 	    y2milestone("Evaluating ProcessDone callback...");
 	    // evaluate the callback function
-	    ycp_handler->evaluateCall();
+	    callback_handler._ycpCallbacks.call(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessFinished);
 	}
 
 	running = false;
     }
+
+    log_limit.reset();
 }
 
 bool PkgProgress::_receiver(const zypp::ProgressData &progress)
 {
-    y2milestone("PkgReceiver progress: %lld (%lld%%), running: %s",
+    // always log the final value
+    y2milestone_ratelimited(log_limit, progress.reportValue() == 100, "PkgReceiver progress: %lld (%lld%%), running: %s",
 	progress.val(), progress.reportValue(), running ? "true" : "false");
 
     if (running)
     {
-	// get the YCP callback handler for destroy event
-	Y2Function* ycp_handler = callback_handler._ycpCallbacks.createCallback(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessProgress);
+	// async operation, just remember the progress
+	AsyncOperation *op = AsyncOperation::current();
+	if (op)
+	{
+	    return op->progress(PkgFunctions::CallbackHandler::YCPCallbacks::cbName(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessProgress),
+		std::vector<long long>(1, progress.reportValue()));
+	}
+
+	// batch mode, queue the event
+	if (callback_handler._ycpCallbacks.isBatched(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessProgress))
+	{
+	    PlainValue args(PlainValue::list());
+	    args.add(PlainValue::integer(progress.reportValue()));
+	    return callback_handler._ycpCallbacks.queueEvent(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessProgress, args);
+	}
 
 	// is the callback registered?
-	if (ycp_handler != NULL)
+	if (callback_handler._ycpCallbacks.isSet(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessProgress))
 	{
-	    ycp_handler->appendParameter(YCPInteger(progress.reportValue()));
+	    PlainValue args(PlainValue::list());
+	    args.add(PlainValue::integer(progress.reportValue()));
 	    // evaluate the callback function
 	    y2debug("Evaluating ProcessProgress callback...");
-	    YCPValue ret = ycp_handler->evaluateCall();
+	    PlainValue ret = callback_handler._ycpCallbacks.call(PkgFunctions::CallbackHandler::YCPCallbacks::CB_ProcessProgress, args);
 
-	    if (!ret.isNull() && ret->isBoolean())
+	    if (ret.kind() == PlainValue::Boolean)
 	    {
-		return ret->asBoolean()->value();
+		return ret.asBoolean();
 	    }
 	    else
 	    {
-		y2error("Callback evaluated to a non-boolean value: %s", ret->toString().c_str());
+		y2error("Callback evaluated to a non-boolean value: %s", ret.toString().c_str());
 	    }
 	}
     }
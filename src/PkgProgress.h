@@ -18,6 +18,8 @@
 #include <zypp/ProgressData.h>
 #include <boost/bind.hpp>
 
+#include "log.h"
+
 class PkgProgress
 {
     public:
@@ -25,7 +27,8 @@ class PkgProgress
 	PkgProgress(PkgFunctions::CallbackHandler &handler_ref)
 	    : callback_handler(handler_ref),
 	    progress_handler(boost::bind(&PkgProgress::_receiver, this, _1)),
-	    running(false)
+	    running(false),
+	    log_limit(1000)
 	{}
 
 	void Start( const std::string &process, const std::list<std::string> &stages, const std::string &help);
@@ -45,6 +48,8 @@ class PkgProgress
 	const PkgFunctions::CallbackHandler &callback_handler;
 	zypp::ProgressData::ReceiverFnc progress_handler;
 	bool running;
+	// the progress is logged at most once per second
+	LogRateLimit log_limit;
 
     protected:
 	bool _receiver(const zypp::ProgressData &progress);
@@ -0,0 +1,217 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	PlainValue.cc
+   Summary:     A copy of a YCP value which can be passed between threads
+*/
+
+#include "PlainValue.h"
+#include "log.h"
+
+#include <ycp/YCPBoolean.h>
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPString.h>
+#include <ycp/YCPSymbol.h>
+#include <ycp/YCPList.h>
+#include <ycp/YCPMap.h>
+#include <ycp/YCPVoid.h>
+
+PlainValue PlainValue::boolean(bool value)
+{
+    PlainValue ret(Boolean);
+    ret._integer = value ? 1 : 0;
+    return ret;
+}
+
+PlainValue PlainValue::integer(long long value)
+{
+    PlainValue ret(Integer);
+    ret._integer = value;
+    return ret;
+}
+
+PlainValue PlainValue::string(const std::string &value)
+{
+    PlainValue ret(String);
+    ret._string = value;
+    return ret;
+}
+
+PlainValue PlainValue::symbol(const std::string &value)
+{
+    PlainValue ret(Symbol);
+    ret._string = value;
+    return ret;
+}
+
+PlainValue PlainValue::list()
+{
+    return PlainValue(List);
+}
+
+PlainValue PlainValue::map()
+{
+    return PlainValue(Map);
+}
+
+PlainValue& PlainValue::add(const PlainValue &item)
+{
+    if (_kind == List)
+	_items.push_back(item);
+    else
+	y2error("Cannot add an item to %s", kindName(_kind));
+
+    return *this;
+}
+
+PlainValue& PlainValue::add(const std::string &key, const PlainValue &value)
+{
+    if (_kind == Map)
+	_entries.push_back(std::make_pair(PlainValue::string(key), value));
+    else
+	y2error("Cannot add a map entry to %s", kindName(_kind));
+
+    return *this;
+}
+
+PlainValue PlainValue::value(const std::string &key) const
+{
+    // the last value wins (like in YCPMap::add())
+    for (Entries::const_reverse_iterator it = _entries.rbegin(); it != _entries.rend(); ++it)
+    {
+	if (it->first._kind == String && it->first._string == key)
+	    return it->second;
+    }
+
+    return PlainValue();
+}
+
+const char* PlainValue::kindName(Kind kind)
+{
+    switch (kind)
+    {
+	case Void: return "void";
+	case Boolean: return "boolean";
+	case Integer: return "integer";
+	case String: return "string";
+	case Symbol: return "symbol";
+	case List: return "list";
+	case Map: return "map";
+    }
+
+    return "unknown";
+}
+
+std::string PlainValue::toString() const
+{
+    switch (_kind)
+    {
+	case Void: return "nil";
+	case Boolean: return _integer ? "true" : "false";
+	case Integer: return std::to_string(_integer);
+	case String: return "\"" + _string + "\"";
+	case Symbol: return "`" + _string;
+	case List:
+	{
+	    std::string ret("[");
+	    for (Items::const_iterator it = _items.begin(); it != _items.end(); ++it)
+		ret += (it == _items.begin() ? "" : ", ") + it->toString();
+	    return ret + "]";
+	}
+	case Map:
+	{
+	    std::string ret("$[");
+	    for (Entries::const_iterator it = _entries.begin(); it != _entries.end(); ++it)
+		ret += (it == _entries.begin() ? "" : ", ") + it->first.toString() + ":" + it->second.toString();
+	    return ret + "]";
+	}
+    }
+
+    return std::string();
+}
+
+YCPValue PlainValue::toYCP() const
+{
+    switch (_kind)
+    {
+	case Void: return YCPVoid();
+	case Boolean: return YCPBoolean(_integer != 0);
+	case Integer: return YCPInteger(_integer);
+	case String: return YCPString(_string);
+	case Symbol: return YCPSymbol(_string);
+	case List:
+	{
+	    YCPList ret;
+	    for (Items::const_iterator it = _items.begin(); it != _items.end(); ++it)
+		ret->add(it->toYCP());
+	    return ret;
+	}
+	case Map:
+	{
+	    YCPMap ret;
+	    for (Entries::const_iterator it = _entries.begin(); it != _entries.end(); ++it)
+		ret->add(it->first.toYCP(), it->second.toYCP());
+	    return ret;
+	}
+    }
+
+    return YCPVoid();
+}
+
+PlainValue PlainValue::fromYCP(const YCPValue &value)
+{
+    if (value.isNull() || value->isVoid())
+	return PlainValue();
+
+    if (value->isBoolean())
+	return PlainValue::boolean(value->asBoolean()->value());
+
+    if (value->isInteger())
+	return PlainValue::integer(value->asInteger()->value());
+
+    if (value->isString())
+	return PlainValue::string(value->asString()->value());
+
+    if (value->isSymbol())
+	return PlainValue::symbol(value->asSymbol()->symbol());
+
+    if (value->isList())
+    {
+	PlainValue ret(PlainValue::list());
+	YCPList lst(value->asList());
+
+	for (int i = 0; i < lst->size(); ++i)
+	    ret.add(fromYCP(lst->value(i)));
+
+	return ret;
+    }
+
+    if (value->isMap())
+    {
+	PlainValue ret(PlainValue::map());
+	YCPMap m(value->asMap());
+
+	for (YCPMap::const_iterator it = m->begin(); it != m->end(); ++it)
+	    ret._entries.push_back(std::make_pair(fromYCP(it->first), fromYCP(it->second)));
+
+	return ret;
+    }
+
+    y2warning("Unsupported value %s, using nil", value->toString().c_str());
+    return PlainValue();
+}
@@ -0,0 +1,116 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	PlainValue.h
+   Summary:     A copy of a YCP value which can be passed between threads
+*/
+
+#ifndef PlainValue_h
+#define PlainValue_h
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <ycp/YCPValue.h>
+
+/**
+ * A YCP value stored in plain C++ types.
+ *
+ * The YCP values are not thread safe (the reference counters and the string
+ * pool are shared with the interpreter), a worker thread must not create,
+ * copy or destroy them. The worker thread uses PlainValue instead, the main
+ * thread converts it from/to YCPValue with fromYCP() and toYCP().
+ *
+ * Only the basic types are supported (boolean, integer, string, symbol,
+ * list and map), the other values are converted to nil.
+ */
+class PlainValue
+{
+    public:
+
+	enum Kind
+	{
+	    Void,
+	    Boolean,
+	    Integer,
+	    String,
+	    Symbol,
+	    List,
+	    Map
+	};
+
+	typedef std::vector<PlainValue> Items;
+	typedef std::vector<std::pair<PlainValue, PlainValue> > Entries;
+
+	// nil
+	PlainValue() : _kind(Void), _integer(0) {}
+
+	static PlainValue boolean(bool value);
+	static PlainValue integer(long long value);
+	static PlainValue string(const std::string &value);
+	static PlainValue symbol(const std::string &value);
+	// an empty list or map
+	static PlainValue list();
+	static PlainValue map();
+
+	Kind kind() const { return _kind; }
+	bool isVoid() const { return _kind == Void; }
+
+	bool asBoolean() const { return _integer != 0; }
+	long long asInteger() const { return _integer; }
+	// the string or the symbol name
+	const std::string& asString() const { return _string; }
+
+	// list items
+	const Items& items() const { return _items; }
+	// map entries
+	const Entries& entries() const { return _entries; }
+
+	// append a list item
+	PlainValue& add(const PlainValue &item);
+	// add a map entry with a string key
+	PlainValue& add(const std::string &key, const PlainValue &value);
+
+	// the map value for a string key, nil if missing
+	PlainValue value(const std::string &key) const;
+
+	// the name of the kind (for logging)
+	static const char* kindName(Kind kind);
+
+	// for logging
+	std::string toString() const;
+
+	// the conversions, call them only in the main thread
+	YCPValue toYCP() const;
+	static PlainValue fromYCP(const YCPValue &value);
+
+    private:
+
+	PlainValue(Kind kind) : _kind(kind), _integer(0) {}
+
+	Kind _kind;
+	// boolean or integer
+	long long _integer;
+	// string or symbol
+	std::string _string;
+	Items _items;
+	Entries _entries;
+};
+
+#endif // PlainValue_h
@@ -0,0 +1,309 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	ProcessPool.cc
+   Summary:     Run independent jobs in parallel in forked processes
+*/
+
+#include "ProcessPool.h"
+#include "AsyncOperation.h"
+#include "log.h"
+
+#include <map>
+#include <exception>
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+static bool in_child = false;
+// the pipe to the parent in a child started by a pool
+static int child_message_fd = -1;
+
+ProcessPool::ProcessPool(unsigned parallel)
+    : _parallel(parallel > 0 ? parallel : 1)
+{
+}
+
+bool ProcessPool::inChild()
+{
+    return in_child;
+}
+
+size_t ProcessPool::add(const std::string &name, const Job &job)
+{
+    _names.push_back(name);
+    _jobs.push_back(job);
+    _results.push_back(NotStarted);
+    _started.push_back(std::chrono::steady_clock::time_point());
+    _durations.push_back(0.0);
+    _messages.push_back(std::string());
+    _fds.push_back(-1);
+
+    return _jobs.size() - 1;
+}
+
+void ProcessPool::report(const std::string &message)
+{
+    if (child_message_fd < 0)
+	return;
+
+    const char *data = message.data();
+    size_t size = message.size();
+
+    while (size > 0)
+    {
+	ssize_t written = ::write(child_message_fd, data, size);
+
+	if (written < 0)
+	{
+	    if (errno == EINTR)
+		continue;
+
+	    y2error("Cannot send the message to the parent: %s", ::strerror(errno));
+	    return;
+	}
+
+	data += written;
+	size -= written;
+    }
+}
+
+void ProcessPool::childMain(const std::string &name, const Job &job, int message_fd)
+{
+    in_child = true;
+    child_message_fd = message_fd;
+    // the worker thread has not been copied to the child
+    AsyncOperation::forkedChild();
+
+    int ret = 1;
+
+    try
+    {
+	ret = job() ? 0 : 1;
+    }
+    catch (const std::exception &e)
+    {
+	y2error("Job %s failed: %s", name.c_str(), e.what());
+    }
+    catch (...)
+    {
+	y2error("Job %s failed", name.c_str());
+    }
+
+    // do not run the atexit handlers and the global destructors,
+    // they would clean up the state shared with the parent (e.g. the temporary directories)
+    ::_exit(ret);
+}
+
+void ProcessPool::finish(size_t index, pid_t pid)
+{
+    ::close(_fds[index]);
+    _fds[index] = -1;
+
+    // the pipe is closed, the child is exiting (or has been killed)
+    int status;
+    pid_t ret;
+    while ((ret = ::waitpid(pid, &status, 0)) < 0 && errno == EINTR)
+	;
+
+    if (ret < 0)
+    {
+	y2error("waitpid(%d) failed: %s", pid, ::strerror(errno));
+	_results[index] = Failed;
+    }
+    else
+    {
+	_results[index] = (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? Succeeded : Failed;
+    }
+
+    _durations[index] = std::chrono::duration<double>(std::chrono::steady_clock::now() - _started[index]).count();
+}
+
+void ProcessPool::run(const Finished &finished)
+{
+    // pid -> job index
+    std::map<pid_t, size_t> running;
+    size_t next = 0;
+    bool stop = false;
+
+    _messages.assign(_jobs.size(), std::string());
+    _fds.assign(_jobs.size(), -1);
+
+    y2milestone("Running %zu jobs, max. %u in parallel", _jobs.size(), _parallel);
+
+    while ((!stop && next < _jobs.size()) || !running.empty())
+    {
+	while (!stop && next < _jobs.size() && running.size() < _parallel)
+	{
+	    _started[next] = std::chrono::steady_clock::now();
+
+	    // the end of the job is detected by closing the pipe, waitpid(-1) cannot be used,
+	    // it would reap the other children of the process (e.g. the SCR agents)
+	    int fds[2];
+	    pid_t pid = -1;
+
+	    if (::pipe2(fds, O_CLOEXEC) == 0)
+	    {
+		pid = ::fork();
+
+		if (pid == 0)
+		{
+		    ::close(fds[0]);
+		    childMain(_names[next], _jobs[next], fds[1]);
+		}
+
+		::close(fds[1]);
+
+		if (pid < 0)
+		    ::close(fds[0]);
+	    }
+
+	    if (pid < 0)
+	    {
+		y2error("Cannot start job %s: %s", _names[next].c_str(), ::strerror(errno));
+
+		if (finished && !finished(next, NotStarted))
+		    stop = true;
+	    }
+	    else
+	    {
+		y2debug("Started job %s (pid %d)", _names[next].c_str(), pid);
+		running[pid] = next;
+		_fds[next] = fds[0];
+	    }
+
+	    ++next;
+	}
+
+	if (running.empty())
+	    break;
+
+	std::vector<struct pollfd> polled;
+	std::vector<pid_t> pids;
+
+	for (std::map<pid_t, size_t>::const_iterator r = running.begin(); r != running.end(); ++r)
+	{
+	    struct pollfd p;
+	    p.fd = _fds[r->second];
+	    p.events = POLLIN;
+	    p.revents = 0;
+
+	    polled.push_back(p);
+	    pids.push_back(r->first);
+	}
+
+	if (::poll(&polled[0], polled.size(), -1) < 0)
+	{
+	    if (errno == EINTR)
+		continue;
+
+	    y2error("poll() failed: %s", ::strerror(errno));
+	    break;
+	}
+
+	for (size_t i = 0; i < polled.size() && !stop; ++i)
+	{
+	    if (polled[i].revents == 0)
+		continue;
+
+	    size_t index = running[pids[i]];
+
+	    char buffer[4096];
+	    ssize_t size = ::read(polled[i].fd, buffer, sizeof(buffer));
+
+	    if (size > 0)
+	    {
+		_messages[index].append(buffer, size);
+		continue;
+	    }
+
+	    if (size < 0 && errno == EINTR)
+		continue;
+
+	    finish(index, pids[i]);
+	    running.erase(pids[i]);
+
+	    y2milestone("Job %s finished: %s", _names[index].c_str(), _results[index] == Succeeded ? "OK" : "failed");
+
+	    if (finished && !finished(index, _results[index]))
+	    {
+		y2milestone("Stopping the remaining jobs");
+		stop = true;
+
+		for (std::map<pid_t, size_t>::const_iterator r = running.begin(); r != running.end(); ++r)
+		    ::kill(r->first, SIGTERM);
+	    }
+	}
+
+	if (stop)
+	    break;
+    }
+
+    // abort: wait for the killed children
+    for (std::map<pid_t, size_t>::const_iterator r = running.begin(); r != running.end(); ++r)
+    {
+	finish(r->second, r->first);
+	_results[r->second] = Killed;
+    }
+}
+
+pid_t ProcessPool::spawn(const std::string &name, const Job &job)
+{
+    pid_t pid = ::fork();
+
+    if (pid == 0)
+	childMain(name, job, -1);
+
+    if (pid < 0)
+    {
+	y2error("Cannot start job %s: %s", name.c_str(), ::strerror(errno));
+	return -1;
+    }
+
+    y2milestone("Started background job %s (pid %d)", name.c_str(), pid);
+
+    return pid;
+}
+
+ProcessPool::Result ProcessPool::wait(pid_t pid)
+{
+    if (pid <= 0)
+	return NotStarted;
+
+    // the pools wait only for their own children, the job cannot be reaped by anybody else
+    int status;
+    while (::waitpid(pid, &status, 0) < 0)
+    {
+	if (errno != EINTR)
+	{
+	    y2error("waitpid(%d) failed: %s", pid, ::strerror(errno));
+	    return Failed;
+	}
+    }
+
+    Result ret = (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? Succeeded : Failed;
+    y2milestone("Background job %d finished: %s", pid, ret == Succeeded ? "OK" : "failed");
+
+    return ret;
+}
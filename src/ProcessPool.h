@@ -0,0 +1,124 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	ProcessPool.h
+   Summary:     Run independent jobs in parallel in forked processes
+*/
+
+#ifndef ProcessPool_h
+#define ProcessPool_h
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+
+#include <sys/types.h>
+
+/**
+ * Runs jobs in forked child processes, at most N at once.
+ *
+ * libzypp is not thread safe (e.g. the media manager is a global singleton),
+ * the forked child has its own copy of the whole state so it can use libzypp
+ * freely. Only the files written by the child (the metadata, the cache)
+ * are visible to the parent, the job result is passed via the exit code.
+ *
+ * The child must not interact with the user, the YCP callbacks are not evaluated
+ * in the child process (libzypp uses the default non-interactive behavior).
+ * The child can pass an error message to the parent via report().
+ *
+ * Only the children started by the pool are waited for, the other child
+ * processes (e.g. the SCR agents) are not touched.
+ */
+class ProcessPool
+{
+    public:
+
+	// the job (run in the child), returns true on success
+	typedef std::function<bool ()> Job;
+
+	enum Result
+	{
+	    // not started at all (e.g. fork() failed)
+	    NotStarted,
+	    Succeeded,
+	    Failed,
+	    // aborted by the parent
+	    Killed
+	};
+
+	/**
+	 * Called in the parent process after a job is finished,
+	 * returning false kills the running jobs and does not start the rest.
+	 */
+	typedef std::function<bool (size_t index, Result result)> Finished;
+
+	ProcessPool(unsigned parallel);
+
+	// add a job, returns its index
+	size_t add(const std::string &name, const Job &job);
+
+	size_t size() const { return _jobs.size(); }
+
+	// run all jobs, returns after all children finish
+	void run(const Finished &finished = Finished());
+
+	Result result(size_t index) const { return _results[index]; }
+
+	// wall time of the finished job in seconds
+	double duration(size_t index) const { return _durations[index]; }
+
+	// the message sent by the job via report(), empty if none
+	const std::string &message(size_t index) const { return _messages[index]; }
+
+	// send a message to the parent process, can be called only from a job
+	// running in a pool (it is ignored otherwise)
+	static void report(const std::string &message);
+
+	// is the current process a child started by a pool?
+	static bool inChild();
+
+	/**
+	 * Run a single job in background (not bound to any pool),
+	 * returns the pid of the child process, -1 on error.
+	 */
+	static pid_t spawn(const std::string &name, const Job &job);
+
+	// wait for a job started by spawn(), each job must be waited for exactly once
+	// (otherwise a zombie process is left)
+	static Result wait(pid_t pid);
+
+    private:
+
+	static void childMain(const std::string &name, const Job &job, int message_fd);
+
+	// a child has exited, evaluate its exit status
+	void finish(size_t index, pid_t pid);
+
+	unsigned _parallel;
+	std::vector<std::string> _names;
+	std::vector<Job> _jobs;
+	std::vector<Result> _results;
+	std::vector<std::chrono::steady_clock::time_point> _started;
+	std::vector<double> _durations;
+	std::vector<std::string> _messages;
+	// the reading end of the pipe to the running child, closed by the child on exit
+	std::vector<int> _fds;
+};
+
+#endif // ProcessPool_h
@@ -90,11 +90,15 @@ PkgFunctions::ResolvableSetPatches (const YCPSymbol& kind_r, bool preselect)
     {
 	// access to the Pool of Selectables
 	zypp::ResPoolProxy selectablePool(zypp::ResPool::instance().proxy());
-	      
+	LogBudget log_budget("patch");
+	unsigned processed = 0;
+
 	// Iterate it's Products...
 	for_(it, selectablePool.byKindBegin<zypp::Patch>(), selectablePool.byKindEnd<zypp::Patch>())
 	{
-	    y2milestone("Procesing patch %s", (*it)->name().c_str());
+	    ++processed;
+	    if (log_budget.allow())
+		y2milestone("Procesing patch %s", (*it)->name().c_str());
 	    zypp::ui::Selectable::Ptr s = *it;
 
 	    if (s && s->isNeeded() && !s->isUnwanted())
@@ -131,6 +135,8 @@ PkgFunctions::ResolvableSetPatches (const YCPSymbol& kind_r, bool preselect)
 		}
 	    }
 	}
+
+	y2milestone("Processed %u patches, needed: %lld", processed, needed_patches);
     }
     catch (...)
     {
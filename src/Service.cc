@@ -305,6 +305,7 @@ YCPValue PkgFunctions::ServiceSet(const YCPString &old_alias, const YCPMap &serv
 			 enabled ? "Enabling" : "Disabling", index, repo_alias.c_str(), old_alias_str.c_str());
 
 		    repo->repoInfo().setEnabled(enabled);
+		    repo->setDirty();
 		}
 	    }
 	}
@@ -371,23 +372,15 @@ YCPValue PkgFunctions::ServiceSet(const YCPString &old_alias, const YCPMap &serv
 
    @return boolean false if failed
 */
-YCPValue PkgFunctions::ServiceRefreshHelper(const YCPString &alias, bool force)
+bool PkgFunctions::ServiceRefreshHelper(const std::string &alias_str, bool force)
 {
     try
     {
-	if (alias.isNull())
-	{
-	    y2error("Error: nil parameter");
-	    return YCPBoolean(false);
-	}
-
-        const std::string alias_str(alias->value());
-
 	zypp::RepoManager* repomanager = CreateRepoManager();
 
 	if (!service_manager.RefreshService(alias_str, *repomanager, force))
 	{
-	    return YCPBoolean(false);
+	    return false;
 	}
 
 	// reload all repositories
@@ -404,6 +397,7 @@ YCPValue PkgFunctions::ServiceRefreshHelper(const YCPString &alias, bool force)
 		if (repomanager->hasRepo(info))
 		{
 		    repos[idx]->repoInfo() = repomanager->getRepositoryInfo(info.alias());
+		    repos[idx]->resetDirty();
 		}
 		else
 		{
@@ -426,7 +420,7 @@ YCPValue PkgFunctions::ServiceRefreshHelper(const YCPString &alias, bool force)
             continue;
 
           y2milestone("Service added a new repository: %s", it->alias().c_str());
-          YRepo_Ptr new_repo = new YRepo(*it);
+          YRepo_Ptr new_repo = new YRepo(*it, false);
           repos.push_back(new_repo);
 
           if (it->enabled())
@@ -434,11 +428,9 @@ YCPValue PkgFunctions::ServiceRefreshHelper(const YCPString &alias, bool force)
             y2milestone("Refreshing repository: %s", it->alias().c_str());
             // refresh the last added repository
 
-            YCPValue refreshed = SourceRefreshNow(repos.size() - 1);
             // return false on refresh failure
-            if (!refreshed.isNull() && refreshed->isBoolean()
-                && !refreshed->asBoolean()->value())
-                return refreshed;
+            if (!SourceRefreshHelper(repos.size() - 1))
+                return false;
 
             // load resolvables
             PkgProgress pkgprogress(_callbackHandler);
@@ -448,18 +440,18 @@ YCPValue PkgFunctions::ServiceRefreshHelper(const YCPString &alias, bool force)
 
             bool loaded = LoadResolvablesFrom(new_repo, subprogrcv_ref);
             // return false on resolvable load failure
-            if (!loaded) return YCPBoolean(false);
+            if (!loaded) return false;
           }
         }
 
-	return YCPBoolean(true);
+	return true;
     }
     catch (const zypp::Exception& excpt)
     {
 	_last_error.setLastError(ExceptionAsString(excpt));
     }
 
-    return YCPBoolean(false);
+    return false;
 }
 
 /**
@@ -470,7 +462,13 @@ YCPValue PkgFunctions::ServiceRefreshHelper(const YCPString &alias, bool force)
 */
 YCPValue PkgFunctions::ServiceRefresh(const YCPString &alias)
 {
-   return ServiceRefreshHelper(alias, false);
+    if (alias.isNull())
+    {
+	y2error("Error: nil parameter");
+	return YCPBoolean(false);
+    }
+
+    return YCPBoolean(ServiceRefreshHelper(alias->value(), false));
 }
 
 /**
@@ -481,7 +479,13 @@ YCPValue PkgFunctions::ServiceRefresh(const YCPString &alias)
 */
 YCPValue PkgFunctions::ServiceForceRefresh(const YCPString &alias)
 {
-   return ServiceRefreshHelper(alias, true);
+    if (alias.isNull())
+    {
+	y2error("Error: nil parameter");
+	return YCPBoolean(false);
+    }
+
+    return YCPBoolean(ServiceRefreshHelper(alias->value(), true));
 }
 
 /**
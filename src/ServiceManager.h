@@ -56,6 +56,9 @@ class ServiceManager
 
 	bool RefreshService(const std::string &alias, zypp::RepoManager &repomgr, bool force = false);
 
+	// read the service again from disk (after it has been refreshed by another process)
+	bool ReloadService(const std::string &alias, const zypp::RepoManager &repomgr);
+
 	std::string Probe(const zypp::Url &url, const zypp::RepoManager &repomgr) const;
 
 	void Reset();
@@ -35,90 +35,94 @@
 
 void PkgFunctions::CallSourceReportStart(const std::string &text)
 {
-    // get the YCP callback handler
-    Y2Function* ycp_handler = _callbackHandler._ycpCallbacks.createCallback(CallbackHandler::YCPCallbacks::CB_SourceReportStart);
+    // deliver the pending progress events first
+    _callbackHandler._ycpCallbacks.flushEvents();
 
     // is the callback registered?
-    if (ycp_handler != NULL)
+    if (_callbackHandler._ycpCallbacks.isSet(CallbackHandler::YCPCallbacks::CB_SourceReportStart))
     {
 	// add parameters
-	ycp_handler->appendParameter( YCPInteger(0LL) );
-	ycp_handler->appendParameter( YCPString("") );
-	ycp_handler->appendParameter( YCPString(text) );
+	PlainValue args(PlainValue::list());
+	args.add(PlainValue::integer(0));
+	args.add(PlainValue::string(""));
+	args.add(PlainValue::string(text));
 	// evaluate the callback function
-	ycp_handler->evaluateCall();
+	_callbackHandler._ycpCallbacks.call(CallbackHandler::YCPCallbacks::CB_SourceReportStart, args);
     }
 }
 
 void PkgFunctions::CallSourceReportEnd(const std::string &text)
 {
-    // get the YCP callback handler for end event
-    Y2Function* ycp_handler = _callbackHandler._ycpCallbacks.createCallback(CallbackHandler::YCPCallbacks::CB_SourceReportEnd);
+    // deliver the pending progress events first
+    _callbackHandler._ycpCallbacks.flushEvents();
 
     // is the callback registered?
-    if (ycp_handler != NULL)
+    if (_callbackHandler._ycpCallbacks.isSet(CallbackHandler::YCPCallbacks::CB_SourceReportEnd))
     {
 	// add parameters
-	ycp_handler->appendParameter( YCPInteger(0LL) );
-	ycp_handler->appendParameter( YCPString("") );
-	ycp_handler->appendParameter( YCPString(text) );
-	ycp_handler->appendParameter( YCPString("NO_ERROR") );
-	ycp_handler->appendParameter( YCPString("") );
+	PlainValue args(PlainValue::list());
+	args.add(PlainValue::integer(0));
+	args.add(PlainValue::string(""));
+	args.add(PlainValue::string(text));
+	args.add(PlainValue::string("NO_ERROR"));
+	args.add(PlainValue::string(""));
 	// evaluate the callback function
-	ycp_handler->evaluateCall();
+	_callbackHandler._ycpCallbacks.call(CallbackHandler::YCPCallbacks::CB_SourceReportEnd, args);
     }
 }
 
 void PkgFunctions::CallSourceReportInit()
 {
-    // get the YCP callback handler for init event
-    Y2Function* ycp_handler = _callbackHandler._ycpCallbacks.createCallback(CallbackHandler::YCPCallbacks::CB_SourceReportInit);
+    // deliver the pending progress events first
+    _callbackHandler._ycpCallbacks.flushEvents();
 
     // is the callback registered?
-    if (ycp_handler != NULL)
+    if (_callbackHandler._ycpCallbacks.isSet(CallbackHandler::YCPCallbacks::CB_SourceReportInit))
     {
 	// evaluate the callback function
-	ycp_handler->evaluateCall();
+	_callbackHandler._ycpCallbacks.call(CallbackHandler::YCPCallbacks::CB_SourceReportInit);
     }
 }
 
 void PkgFunctions::CallSourceReportDestroy()
 {
-    // get the YCP callback handler for destroy event
-    Y2Function* ycp_handler = _callbackHandler._ycpCallbacks.createCallback(CallbackHandler::YCPCallbacks::CB_SourceReportDestroy);
+    // deliver the pending progress events first
+    _callbackHandler._ycpCallbacks.flushEvents();
 
     // is the callback registered?
-    if (ycp_handler != NULL)
+    if (_callbackHandler._ycpCallbacks.isSet(CallbackHandler::YCPCallbacks::CB_SourceReportDestroy))
     {
 	// evaluate the callback function
-	ycp_handler->evaluateCall();
+	_callbackHandler._ycpCallbacks.call(CallbackHandler::YCPCallbacks::CB_SourceReportDestroy);
     }
 }
 
 void PkgFunctions::CallInitDownload(const std::string &task)
 {
-    // get the YCP callback handler for destroy event
-    Y2Function* ycp_handler = _callbackHandler._ycpCallbacks.createCallback(CallbackHandler::YCPCallbacks::CB_InitDownload);
+    // deliver the pending progress events first
+    _callbackHandler._ycpCallbacks.flushEvents();
 
     // is the callback registered?
-    if (ycp_handler != NULL)
+    if (_callbackHandler._ycpCallbacks.isSet(CallbackHandler::YCPCallbacks::CB_InitDownload))
     {
-	ycp_handler->appendParameter(YCPString(task));
+	// add parameters
+	PlainValue args(PlainValue::list());
+	args.add(PlainValue::string(task));
 	// evaluate the callback function
-	ycp_handler->evaluateCall();
+	_callbackHandler._ycpCallbacks.call(CallbackHandler::YCPCallbacks::CB_InitDownload, args);
     }
 }
 
 void PkgFunctions::CallDestDownload()
 {
-    // get the YCP callback handler for destroy event
-    Y2Function* ycp_handler = _callbackHandler._ycpCallbacks.createCallback(CallbackHandler::YCPCallbacks::CB_DestDownload);
+    // deliver the pending progress events first
+    _callbackHandler._ycpCallbacks.flushEvents();
 
     // is the callback registered?
-    if (ycp_handler != NULL)
+    if (_callbackHandler._ycpCallbacks.isSet(CallbackHandler::YCPCallbacks::CB_DestDownload))
     {
 	// evaluate the callback function
-	ycp_handler->evaluateCall();
+	_callbackHandler._ycpCallbacks.call(CallbackHandler::YCPCallbacks::CB_DestDownload);
     }
 }
 
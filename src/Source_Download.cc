@@ -35,6 +35,21 @@
 #include <HelpTexts.h>
 
 #include <zypp/Fetcher.h>
+#include <zypp/FileChecker.h>
+#include <zypp/PathInfo.h>
+#include <zypp/KeyRing.h>
+#include <zypp/KeyContext.h>
+#include <zypp/PublicKey.h>
+#include <zypp/ZYppFactory.h>
+#include <zypp/base/String.h>
+
+#include "DigestVerifier.h"
+
+#include <fstream>
+#include <iterator>
+
+#include <ycp/YCPList.h>
+#include <ycp/YCPMap.h>
 
 /*
   Textdomain "pkg-bindings"
@@ -103,13 +118,15 @@ YCPValue PkgFunctions::SourceProvideFileCommon(const YCPInteger &id,
 
 		// create the tmpdir in <_download_area>
 		zypp::filesystem::TmpDir tmpdir(download_area_path());
-
-		// keep a reference to the tmpdir so the directory is not deleted at the and of the block		
-		tmp_dirs.push_back(tmpdir);
 		path = tmpdir.path();
 
+		zypp::Pathname cache;
+
 		if (digested)
 		{
+		    // the checksum is known, reuse the previously downloaded file
+		    cache = ProvideCachePath(repo, mid->value());
+		    fch.addCachePath(cache);
 		    fch.enqueueDigested(mloc);
 		}
 		else
@@ -119,6 +136,13 @@ YCPValue PkgFunctions::SourceProvideFileCommon(const YCPInteger &id,
 
 		fch.start(path, *repo->mediaAccess()); // uses MediaAccess to retrieve
 		fch.reset();
+
+		if (digested)
+		    ProvideCacheStore(cache, path, media_path);
+
+		// keep a reference to the tmpdir so the directory is not deleted at the end of the block
+		download_area.add(tmpdir);
+
 		path /= f->value();
 	    }
 	    else
@@ -274,6 +298,271 @@ PkgFunctions::SourceProvideDigestedFile (const YCPInteger& id, const YCPInteger&
     return SourceProvideFileCommon(id, mid, f, optional->value() /*optional*/, true /* signed */, true /* digested */);
 }
 
+// the path on the medium - add "/" to the beginning if it's missing there
+static std::string mediaPath(const std::string &file)
+{
+    if (!file.empty() && file[0] != '/')
+	return "/" + file;
+
+    return file;
+}
+
+// add a file to the fetcher, signed files are added as an index (checked by the signature)
+static void enqueueFile(zypp::Fetcher &fetcher, const std::string &file, unsigned medium, bool optional, bool digested)
+{
+    zypp::OnMediaLocation mloc(mediaPath(file), medium);
+    mloc.setOptional(optional);
+
+    if (digested)
+	fetcher.enqueueDigested(mloc);
+    else
+	fetcher.addIndex(mloc);
+}
+
+/**
+ * @builtin SourceProvideFiles
+ *
+ * @short Make several files available at the local filesystem
+ * @description
+ * Downloads the files from the same repository and medium at once. The signed and digested
+ * files are downloaded by a single fetcher, i.e. the checksum index is downloaded and
+ * its signature is checked only once for all files.
+ * Warning: The downloaded files are removed in Pkg::SourceReleaseAll()!
+ *
+ * Supported options:
+ * "optional" (boolean) - the files can be missing on the medium (default: false)
+ * "verify" (string) - "digested" (the checksum is stored in the SHA1SUMS or CHECKSUMS file, default),
+ *   "signed" (the signature is read from <filename>.asc file) or "none" (no check,
+ *   the same as SourceProvideFile())
+ *
+ * @param integer id Source ID
+ * @param integer mid Number of the media the files are located on ('1' for the 1st media).
+ * @param list<string> files File names relative to the media root.
+ * @param map options the options
+ *
+ * @return map $[ "file" : $[ "path" : "local path" ], "file2" : $[ "error" : "error message" ] ],
+ *   nil on invalid arguments
+ **/
+YCPValue
+PkgFunctions::SourceProvideFiles(const YCPInteger& id, const YCPInteger& mid, const YCPList& files, const YCPMap& options)
+{
+    if (id.isNull() || mid.isNull() || files.isNull())
+    {
+	y2error("SourceProvideFiles: nil argument!");
+	return YCPVoid();
+    }
+
+    bool optional = false;
+    std::string verify("digested");
+
+    if (!options.isNull())
+    {
+	YCPValue val = options->value(YCPString("optional"));
+	if (!val.isNull() && val->isBoolean())
+	    optional = val->asBoolean()->value();
+
+	val = options->value(YCPString("verify"));
+	if (!val.isNull() && val->isString())
+	    verify = val->asString()->value();
+    }
+
+    if (verify != "digested" && verify != "signed" && verify != "none")
+    {
+	y2error("SourceProvideFiles: invalid 'verify' option: %s", verify.c_str());
+	return YCPVoid();
+    }
+
+    std::vector<std::string> names;
+    for (int i = 0; i < files->size(); ++i)
+    {
+	if (files->value(i)->isString())
+	    names.push_back(files->value(i)->asString()->value());
+	else
+	    y2error("SourceProvideFiles: ignoring invalid file name: %s", files->value(i)->toString().c_str());
+    }
+
+    YRepo_Ptr repo = logFindRepository(id->value());
+    if (!repo)
+	return YCPVoid();
+
+    YCPMap ret;
+
+    if (names.empty())
+	return ret;
+
+    y2milestone("Downloading %zu %sfiles (verify: %s) from repository %lld, medium %lld",
+	names.size(), optional ? "optional " : "", verify.c_str(), id->value(), mid->value());
+
+    CallInitDownload(std::string(_("Downloading ")) + names.front() + (names.size() > 1 ? ", ..." : ""));
+
+    extern ZyppRecipients::MediaChangeSensitivity _silent_probing;
+    // remember the current value
+    ZyppRecipients::MediaChangeSensitivity _silent_probing_old = _silent_probing;
+
+    // disable media change callback for optional files
+    if (optional)
+	_silent_probing = ZyppRecipients::MEDIA_CHANGE_OPTIONALFILE;
+
+    // remember the current repo (needed at GPG key import)
+    current_repo = id->value();
+
+    // file -> local path or error
+    std::map<std::string, zypp::Pathname> paths;
+    std::map<std::string, std::string> errors;
+
+    if (verify == "none")
+    {
+	for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+	{
+	    try
+	    {
+		paths[*it] = repo->mediaAccess()->provideFile(*it, mid->value());
+	    }
+	    catch (const zypp::Exception& excpt)
+	    {
+		errors[*it] = ExceptionAsString(excpt);
+	    }
+	}
+    }
+    else
+    {
+	bool digested = verify == "digested";
+	// the checksum is known for the digested files, reuse the previously downloaded files
+	zypp::Pathname cache;
+	if (digested)
+	    cache = ProvideCachePath(repo, mid->value());
+
+	// create the tmpdir in <_download_area>
+	zypp::filesystem::TmpDir tmpdir(download_area_path());
+	zypp::Pathname dir(tmpdir.path());
+
+	// download the files separately to find out which file has failed
+	bool per_file = false;
+	// the index (SHA1SUMS, CHECKSUMS) cannot be verified, it's the same error for all files
+	std::string index_error;
+
+	try
+	{
+	    // all files at once
+	    zypp::Fetcher fch;
+	    fch.setOptions(zypp::Fetcher::AutoAddIndexes);
+	    if (digested)
+		fch.addCachePath(cache);
+
+	    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+		enqueueFile(fch, *it, mid->value(), optional, digested);
+
+	    fch.start(dir, *repo->mediaAccess());
+	}
+	catch (const zypp::SignatureCheckException& excpt)
+	{
+	    // only the index is signed in the digested mode, each file has its own signature otherwise
+	    if (digested)
+	    {
+		y2error("Cannot verify the index file: %s", excpt.asString().c_str());
+		index_error = ExceptionAsString(excpt);
+	    }
+	    else
+	    {
+		y2warning("Downloading the files at once failed, downloading them separately: %s", excpt.asString().c_str());
+		per_file = true;
+	    }
+	}
+	catch (const zypp::Exception& excpt)
+	{
+	    y2warning("Downloading the files at once failed, downloading them separately: %s", excpt.asString().c_str());
+	    per_file = true;
+	}
+
+	if (per_file || !index_error.empty())
+	{
+	    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+	    {
+		if (zypp::PathInfo(dir / *it).isFile())
+		    continue;
+
+		// do not ask the user and download the index again for each file
+		if (!index_error.empty())
+		{
+		    errors[*it] = index_error;
+		    continue;
+		}
+
+		try
+		{
+		    zypp::Fetcher fch;
+		    fch.setOptions(zypp::Fetcher::AutoAddIndexes);
+		    if (digested)
+			fch.addCachePath(cache);
+		    enqueueFile(fch, *it, mid->value(), optional, digested);
+		    fch.start(dir, *repo->mediaAccess());
+		}
+		catch (const zypp::SignatureCheckException& excpt)
+		{
+		    if (digested)
+		    {
+			y2error("Cannot verify the index file: %s", excpt.asString().c_str());
+			index_error = ExceptionAsString(excpt);
+		    }
+
+		    errors[*it] = ExceptionAsString(excpt);
+		}
+		catch (const zypp::Exception& excpt)
+		{
+		    errors[*it] = ExceptionAsString(excpt);
+		}
+	    }
+	}
+
+	for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+	{
+	    if (errors.find(*it) == errors.end())
+	    {
+		paths[*it] = dir / *it;
+
+		if (digested)
+		    ProvideCacheStore(cache, dir, mediaPath(*it));
+	    }
+	}
+
+	// keep a reference to the tmpdir so the directory is not deleted at the end of the block
+	download_area.add(tmpdir);
+    }
+
+    current_repo = -1LL;
+
+    // set the original probing value
+    _silent_probing = _silent_probing_old;
+
+    CallDestDownload();
+
+    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+    {
+	YCPMap result;
+	std::map<std::string, zypp::Pathname>::const_iterator path = paths.find(*it);
+
+	if (path != paths.end() && zypp::PathInfo(path->second).isFile())
+	{
+	    result->add(YCPString("path"), YCPString(path->second.asString()));
+	}
+	else
+	{
+	    std::map<std::string, std::string>::const_iterator error = errors.find(*it);
+	    std::string msg(error != errors.end() ? error->second : std::string(_("File not found")));
+
+	    y2milestone("File not found: %s", it->c_str());
+	    result->add(YCPString("error"), YCPString(msg));
+
+	    if (!optional)
+		_last_error.setLastError(msg);
+	}
+
+	ret->add(YCPString(*it), result);
+    }
+
+    return ret;
+}
+
 /**
  * @builtin SourceProvideDirectory
  * @short make a directory available at the local filesystem
@@ -319,6 +608,199 @@ PkgFunctions::SourceProvideSignedDirectory(const YCPInteger& id, const YCPIntege
     return SourceProvideDirectoryInternal(id, mid, d, optional, recursive, true);
 }
 
+// the signed checksums index in a directory (see zypp::Fetcher::AutoAddChecksumsIndexes)
+static const char *checksums_index = "CHECKSUMS";
+
+static bool dirContains(const zypp::filesystem::DirContent &content, const std::string &name)
+{
+    for (zypp::filesystem::DirContent::const_iterator it = content.begin(); it != content.end(); ++it)
+    {
+	if (it->name == name && (it->type == zypp::filesystem::FT_FILE || it->type == zypp::filesystem::FT_NOT_AVAIL))
+	    return true;
+    }
+
+    return false;
+}
+
+// download a file from the medium to the local path
+static void provideTo(zypp::MediaSetAccess &media, const zypp::Pathname &file, unsigned medium, const zypp::Pathname &local)
+{
+    zypp::Pathname provided(media.provideFile(zypp::OnMediaLocation(file, medium)));
+
+    if (zypp::filesystem::hardlinkCopy(provided, local) != 0)
+	ZYPP_THROW(zypp::Exception("Cannot copy " + provided.asString() + " to " + local.asString()));
+}
+
+// the checksums from a signed index (the path relative to the index directory -> checksum)
+typedef std::map<std::string, zypp::CheckSum> SignedChecksums;
+
+// download the signed checksums index of the directory and verify its signature
+static SignedChecksums readSignedIndex(const YRepo_Ptr &repo, const zypp::filesystem::DirContent &content,
+    const zypp::Pathname &dir, unsigned medium, const zypp::Pathname &local_dir)
+{
+    zypp::MediaSetAccess &media(*repo->mediaAccess());
+    zypp::Pathname index(dir / checksums_index);
+    zypp::Pathname local_index(local_dir / checksums_index);
+
+    provideTo(media, index, medium, local_index);
+    provideTo(media, index.extend(".asc"), medium, local_index.extend(".asc"));
+
+    zypp::KeyRing_Ptr keyring(zypp::getZYpp()->keyRing());
+
+    // import the attached key (not trusted), the user is asked to trust it
+    if (dirContains(content, std::string(checksums_index) + ".key"))
+    {
+	provideTo(media, index.extend(".key"), medium, local_index.extend(".key"));
+	zypp::PublicKey key(local_index.extend(".key"));
+
+	if (!keyring->isKeyKnown(key.id()))
+	    keyring->importKey(key, false);
+    }
+
+    zypp::KeyContext context;
+    context.setRepoInfo(repo->repoInfo());
+    bool signature_valid = false;
+
+    if (!keyring->verifyFileSignatureWorkflow(local_index, index.asString(), local_index.extend(".asc"), signature_valid, context))
+	ZYPP_THROW(zypp::Exception("Signature verification failed for " + index.asString()));
+
+    // "<checksum> <file>" lines, the file might be in a subdirectory ("./sub/file")
+    SignedChecksums ret;
+    std::ifstream in(local_index.c_str());
+    std::string line;
+
+    while (std::getline(in, line))
+    {
+	std::vector<std::string> words;
+	zypp::str::split(line, std::back_inserter(words));
+
+	if (words.size() < 2)
+	    continue;
+
+	// the file name might be prefixed by "*" (binary mode) or "./"
+	std::string name(words[1]);
+	if (name.compare(0, 1, "*") == 0)
+	    name.erase(0, 1);
+	if (name.compare(0, 2, "./") == 0)
+	    name.erase(0, 2);
+
+	ret[name] = zypp::CheckSum(words[0]);
+    }
+
+    return ret;
+}
+
+// the state of downloading a signed directory
+struct SignedDirFetch
+{
+    SignedDirFetch(const YRepo_Ptr &r, unsigned m, bool rec, const zypp::Pathname &t, const zypp::Pathname &c)
+	: repo(r), medium(m), recursive(rec), target(t), cache(c) {}
+
+    YRepo_Ptr repo;
+    unsigned medium;
+    bool recursive;
+    // the local directory
+    zypp::Pathname target;
+    // the provide cache (see ProvideCachePath())
+    zypp::Pathname cache;
+
+    DigestVerifier verifier;
+    // the indexes of the current directory and its parents (the nearest last)
+    std::vector<std::pair<zypp::Pathname, SignedChecksums> > indexes;
+    // the downloaded files (not taken from the cache), stored to the cache when verified
+    std::vector<std::string> downloaded;
+
+    // find the checksum of the file in the nearest index which lists it
+    zypp::CheckSum checksum(const zypp::Pathname &file) const
+    {
+	for (std::vector<std::pair<zypp::Pathname, SignedChecksums> >::const_reverse_iterator it = indexes.rbegin();
+	    it != indexes.rend(); ++it)
+	{
+	    std::string dir(it->first.asString());
+	    if (dir.empty() || dir[dir.size() - 1] != '/')
+		dir += "/";
+
+	    if (!zypp::str::hasPrefix(file.asString(), dir))
+		continue;
+
+	    SignedChecksums::const_iterator found = it->second.find(file.asString().substr(dir.size()));
+
+	    if (found != it->second.end())
+		return found->second;
+	}
+
+	return zypp::CheckSum();
+    }
+};
+
+/**
+ * Download a directory, the files are verified by the checksums from the signed
+ * index in parallel (while downloading the next files). The checksums can be listed
+ * in the index of the directory or of any parent directory. The files found in the
+ * provide cache with the expected checksum are not downloaded again.
+ * @return false if the directory does not contain a signed index
+ * @throws zypp::Exception on error
+ */
+static bool fetchSignedDir(SignedDirFetch &fetch, const zypp::Pathname &dir, bool top)
+{
+    zypp::MediaSetAccess &media(*fetch.repo->mediaAccess());
+    zypp::filesystem::DirContent content;
+    media.dirInfo(content, dir, false, fetch.medium);
+
+    bool signed_index = dirContains(content, checksums_index) && dirContains(content, std::string(checksums_index) + ".asc");
+
+    // let the Fetcher handle the unsigned directory (it asks the user)
+    if (top && !signed_index)
+	return false;
+
+    zypp::Pathname local_dir(fetch.target / dir);
+    zypp::filesystem::assert_dir(local_dir);
+
+    // the files not listed in any index are reported as failed
+    if (signed_index)
+	fetch.indexes.push_back(std::make_pair(dir, readSignedIndex(fetch.repo, content, dir, fetch.medium, local_dir)));
+
+    for (zypp::filesystem::DirContent::const_iterator it = content.begin(); it != content.end(); ++it)
+    {
+	if (it->type == zypp::filesystem::FT_DIR)
+	{
+	    if (fetch.recursive)
+		fetchSignedDir(fetch, dir / it->name, false);
+
+	    continue;
+	}
+
+	// the index has been downloaded already
+	if (zypp::str::hasPrefix(it->name, checksums_index))
+	    continue;
+
+	if (it->type != zypp::filesystem::FT_FILE && it->type != zypp::filesystem::FT_NOT_AVAIL)
+	    continue;
+
+	zypp::Pathname file(dir / it->name);
+	zypp::Pathname local(local_dir / it->name);
+	zypp::CheckSum checksum(fetch.checksum(file));
+
+	// reuse the previously provided file
+	zypp::Pathname cached(fetch.cache / file);
+	if (!checksum.empty() && zypp::PathInfo(cached).isFile() && DigestVerifier::verify(cached, checksum).empty()
+	    && zypp::filesystem::hardlinkCopy(cached, local) == 0)
+	{
+	    y2debug("Using cached file %s", file.c_str());
+	    continue;
+	}
+
+	provideTo(media, file, fetch.medium, local);
+	fetch.downloaded.push_back(file.asString());
+	fetch.verifier.add(local, checksum, file.asString());
+    }
+
+    if (signed_index)
+	fetch.indexes.pop_back();
+
+    return true;
+}
+
 YCPValue
 PkgFunctions::SourceProvideDirectoryInternal(const YCPInteger& id, const YCPInteger& mid, const YCPString& d, const YCPBoolean &optional, const YCPBoolean &recursive, bool check_signatures)
 {
@@ -345,20 +827,55 @@ PkgFunctions::SourceProvideDirectoryInternal(const YCPInteger& id, const YCPInte
 	{
 	    if (check_signatures)
 	    {
-		// use a Fetcher for downloading signed files (see bnc#409927)
-		zypp::Fetcher f;
-		f.reset();
-		zypp::OnMediaLocation mloc(d->value(), mid->value());
 		// create the tmpdir in <_download_area>
 		zypp::filesystem::TmpDir tmpdir(download_area_path());
-
-		// keep the reference to the tmpdir so the directory is not deleted at the and of the block
-		tmp_dirs.push_back(tmpdir);
 		path = tmpdir.path();
-		f.setOptions(zypp::Fetcher::AutoAddIndexes);
-		f.enqueueDigestedDir(mloc, recursive->value());
-		f.start(path, *repo->mediaAccess()); // uses MediaAccess to retrieve
-		f.reset();
+
+		SignedDirFetch fetch(repo, mid->value(), recursive->value(), path, ProvideCachePath(repo, mid->value()));
+
+		if (fetchSignedDir(fetch, d->value(), true))
+		{
+		    // report all failed files at once
+		    std::map<std::string, std::string> failed(fetch.verifier.finish());
+
+		    // cache the verified files
+		    for (std::vector<std::string>::const_iterator it = fetch.downloaded.begin(); it != fetch.downloaded.end(); ++it)
+		    {
+			if (failed.find(*it) == failed.end())
+			    ProvideCacheStore(fetch.cache, path, *it);
+		    }
+
+		    if (!failed.empty())
+		    {
+			std::string details;
+
+			for (std::map<std::string, std::string>::const_iterator it = failed.begin(); it != failed.end(); ++it)
+			{
+			    y2error("Verification of %s failed: %s", it->first.c_str(), it->second.c_str());
+			    details += it->first + ": " + it->second + "\n";
+			}
+
+			ZYPP_THROW(zypp::Exception(zypp::str::form(_("Verification of %zu files failed:"), failed.size()) + "\n" + details));
+		    }
+		}
+		else
+		{
+		    y2milestone("No signed index in %s, using the Fetcher", d->value_cstr());
+
+		    // use a Fetcher for downloading signed files (see bnc#409927)
+		    zypp::Fetcher f;
+		    f.reset();
+		    zypp::OnMediaLocation mloc(d->value(), mid->value());
+		    f.setOptions(zypp::Fetcher::AutoAddIndexes);
+		    // reuse the files provided before
+		    f.addCachePath(ProvideCachePath(repo, mid->value()));
+		    f.enqueueDigestedDir(mloc, recursive->value());
+		    f.start(path, *repo->mediaAccess()); // uses MediaAccess to retrieve
+		    f.reset();
+		}
+
+		// keep the reference to the tmpdir so the directory is not deleted at the end of the block
+		download_area.add(tmpdir);
 	    }
 	    else
 	    {
@@ -390,14 +907,14 @@ PkgFunctions::SourceProvideDirectoryInternal(const YCPInteger& id, const YCPInte
 
 
 
-YCPValue
-PkgFunctions::SourceRefreshHelper (const YCPInteger& id, bool forced)
+bool
+PkgFunctions::SourceRefreshHelper (RepoId id, bool forced)
 {
     y2milestone("Forced refresh : %s", forced ? "true" : "false");
 
-    YRepo_Ptr repo = logFindRepository(id->value());
+    YRepo_Ptr repo = logFindRepository(id);
     if (!repo)
-	return YCPBoolean(false);
+	return false;
 
     PkgProgress pkgprogress(_callbackHandler);
     std::list<std::string> stages;
@@ -430,12 +947,12 @@ PkgFunctions::SourceRefreshHelper (const YCPInteger& id, bool forced)
     {
 	y2error ("Error while refreshing the source: %s", expt.asString().c_str());
 	_last_error.setLastError(repo->repoInfo().alias() + ": " + ExceptionAsString(expt));
-	return YCPBoolean(false);
+	return false;
     }
 
     pkgprogress.Done();
 
-    return YCPBoolean( true );
+    return true;
 }
 
 /**
@@ -453,7 +970,7 @@ YCPValue
 PkgFunctions::SourceRefreshNow (const YCPInteger& id)
 {
     // refresh if needed
-    return SourceRefreshHelper(id);
+    return YCPBoolean(SourceRefreshHelper(id->value()));
 }
 
 /**
@@ -470,7 +987,7 @@ YCPValue
 PkgFunctions::SourceForceRefreshNow (const YCPInteger& id)
 {
     // force refresh
-    return SourceRefreshHelper(id, true);
+    return YCPBoolean(SourceRefreshHelper(id->value(), true));
 }
 
 zypp::Pathname PkgFunctions::download_area_path()
@@ -478,3 +995,122 @@ zypp::Pathname PkgFunctions::download_area_path()
     // create the tmpdir in the default location if _download_area is empty
     return _download_area.empty() ? zypp::filesystem::TmpDir::defaultLocation() : _download_area;
 }
+
+zypp::Pathname PkgFunctions::ProvideCachePath(const YRepo_Ptr &repo, unsigned medium)
+{
+    zypp::Pathname ret(download_area.cache(download_area_path()) / repo->repoInfo().escaped_alias() / zypp::str::numstring(medium));
+    zypp::filesystem::assert_dir(ret);
+
+    return ret;
+}
+
+void PkgFunctions::ProvideCacheStore(const zypp::Pathname &cache, const zypp::Pathname &dir, const std::string &file)
+{
+    zypp::Pathname source(dir / file);
+    zypp::Pathname target(cache / file);
+
+    // missing optional file
+    if (!zypp::PathInfo(source).isFile())
+	return;
+
+    // already cached (the file has been copied from the cache), just mark it as used
+    if (zypp::PathInfo(target).isFile())
+    {
+	y2debug("File %s is already cached", file.c_str());
+	download_area.cached(target);
+	return;
+    }
+
+    zypp::filesystem::assert_dir(target.dirname());
+
+    if (zypp::filesystem::hardlinkCopy(source, target) != 0)
+	y2warning("Cannot cache file %s", source.c_str());
+    else
+	download_area.cached(target);
+}
+
+/**
+ * @builtin DownloadAreaStats
+ * @short Usage of the download area
+ * @description
+ * Returns the size of the files provided by SourceProvideSignedFile(), SourceProvideDigestedFile(),
+ * SourceProvideSignedDirectory() and SourceProvideFiles() kept in the download area
+ * and the number of the removed directories.
+ *
+ * @return map $[ "limit" : integer (bytes, 0 = unlimited), "usage" : integer (bytes), "peak" : integer (bytes),
+ *   "entries" : integer (number of directories), "pinned" : integer (number of pinned directories),
+ *   "cache" : integer (size of the cached digested files), "evictions" : integer, "evicted_bytes" : integer ]
+ */
+YCPValue PkgFunctions::DownloadAreaStats()
+{
+    return download_area.stats();
+}
+
+/**
+ * @builtin SetDownloadAreaLimit
+ * @short Limit the size of the download area
+ * @description
+ * When the size of the provided files exceeds the limit the least recently used
+ * directories are removed (in the order they were provided or passed to DownloadAreaPin(),
+ * except the pinned ones), a path returned by a previous SourceProvide* call might
+ * not exist anymore, pin the files which are still needed. The last provided directory
+ * is never removed. Then the least recently provided cached digested files
+ * not used by any provided directory are removed.
+ *
+ * @param integer limit the limit in bytes, 0 = unlimited (the default)
+ * @return boolean true on success
+ */
+YCPValue PkgFunctions::SetDownloadAreaLimit(const YCPInteger& limit)
+{
+    if (limit.isNull() || limit->value() < 0)
+    {
+	y2error("Invalid download area limit: %s", limit.isNull() ? "nil" : limit->toString().c_str());
+	return YCPBoolean(false);
+    }
+
+    download_area.setLimit(limit->value());
+
+    return YCPBoolean(true);
+}
+
+/**
+ * @builtin DownloadAreaPin
+ * @short Keep a provided file in the download area
+ * @description
+ * A pinned file (the whole directory containing it) is not removed when
+ * the download area limit is exceeded, it is removed by SourceReleaseAll().
+ *
+ * @param string path path returned by a SourceProvide* builtin
+ * @param boolean pin true = pin, false = unpin
+ * @return boolean false if the path is not in the download area
+ */
+YCPValue PkgFunctions::DownloadAreaPin(const YCPString& path, const YCPBoolean& pin)
+{
+    if (path.isNull() || pin.isNull())
+    {
+	y2error("Missing argument");
+	return YCPBoolean(false);
+    }
+
+    return YCPBoolean(download_area.pin(path->value(), pin->value()));
+}
+
+/**
+ * @builtin DownloadStats
+ * @short Download statistics
+ * @description
+ * Returns the statistics of all file downloads (metadata, packages, provided files)
+ * per repository and per server. The retries and the failures are counted per file.
+ * The downloads done in the forked processes are not included: the metadata
+ * with "parallel_refresh" > 1 (see SourceLoadOptions()), PrefetchPackages()
+ * and the Commit() "pipeline" downloads.
+ *
+ * @return map $[ "repositories" : $[ alias : stats, ... ], "hosts" : $[ host : stats, ... ] ],
+ *   stats: $[ "transfers" : integer (number of downloaded files), "bytes" : integer,
+ *   "time" : integer (milliseconds), "avg_bps" : integer (bytes per second), "peak_bps" : integer,
+ *   "retries" : integer, "failures" : integer ]
+ */
+YCPValue PkgFunctions::DownloadStats()
+{
+    return transfer_stats.asYCPMap();
+}
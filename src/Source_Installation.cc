@@ -28,7 +28,9 @@
 #include <PkgFunctions.h>
 #include "log.h"
 
-#include <zypp/ExternalProgram.h>
+#include "FileCopy.h"
+
+#include <zypp/PathInfo.h>
 
 #include <ycp/YCPBoolean.h>
 #include <ycp/YCPVoid.h>
@@ -82,22 +84,8 @@ bool PkgFunctions::CreateDir(const std::string &path)
 	{
 	    y2milestone("Creating directory %s...", path.c_str());
 
-	    const char* argv[] =
-	    {
-	      "mkdir",
-	      // create parent dir
-	      "-p",
-	      // finish parameter list
-	      "--",
-	      // target
-	      path.c_str(),
-	      NULL
-	    };
-
-	    // discard stderr, no pty, stderr_fd = -1, use the default locale
-	    zypp::ExternalProgram prog(argv, zypp::ExternalProgram::Discard_Stderr, false, -1, true);
-
-	    if (prog.close())
+	    // create the parent directories as well (like "mkdir -p")
+	    if (zypp::filesystem::assert_dir(path) != 0)
 	    {
 		// error message (followed by directory name)
 		_last_error.setLastError(_("Cannot create directory ") + path);
@@ -118,7 +106,7 @@ bool PkgFunctions::CreateDir(const std::string &path)
     return true;
 }
 
-bool PkgFunctions::CopyToDir(const std::string &source, const std::string &target, bool backup, bool recursive)
+bool PkgFunctions::CopyToDir(const std::string &source, const std::string &target, bool backup)
 {
     if (source.empty())
     {
@@ -146,51 +134,15 @@ bool PkgFunctions::CopyToDir(const std::string &source, const std::string &targe
 	return false;
     }
 
-    const char* argv[] =
-    {
-      "cp",
-      // preserve the time stamps and permissions
-      "-a",
-      // fill the parameters later
-      NULL,
-      NULL,
-      NULL,
-      NULL,
-      NULL,
-      NULL
-    };
-
-    int pos = 2;
-
-    if (recursive)
-    {
-	argv[pos++] = "-r";
-    }
-
-    if (backup)
-    {
-	argv[pos++] = "-b";
-    }
-
-    // finish parameter list
-    argv[pos++] = "--";
-
-    // source
-    argv[pos++] = source.c_str();
-
-    // target
-    argv[pos++] = target.c_str();
-
-    // discard stderr, no pty, stderr_fd = -1, use the default locale
-    zypp::ExternalProgram prog(argv, zypp::ExternalProgram::Discard_Stderr, false, -1, true);
-
-    if (prog.close())
+    // like "cp -a" (or "cp -a -b"), but without starting an external program
+    std::string error;
+    if (!copyTree(source, target, backup, error))
     {
 	// error message (followed by detailed description)
 	const std::string msg = _("Error: Cannot copy the cache to the target directory\n");
 
 	// error message
-	_last_error.setLastError(msg + _("Copying failed"));
+	_last_error.setLastError(msg + _("Copying failed"), error);
 	y2error("Cannot copy %s to %s", source.c_str(), target.c_str());
 	return false;
     }
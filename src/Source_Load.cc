@@ -30,10 +30,25 @@
 
 #include <PkgFunctions.h>
 #include "log.h"
+#include "ProcessPool.h"
 
 #include <PkgProgress.h>
 #include <HelpTexts.h>
 
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/media/ProxyInfo.h>
+
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPList.h>
+
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <unistd.h>
+
 /*
   Textdomain "pkg-bindings"
 */
@@ -61,6 +76,9 @@ PkgFunctions::SourceRestore()
 	return YCPBoolean(success);
     }
 
+    // collect the statistics of the service refresh and the following SourceLoad()
+    load_stats.reset();
+
     try
     {
 	zypp::RepoManager* repomanager = CreateRepoManager();
@@ -79,27 +97,67 @@ PkgFunctions::SourceRestore()
 		{
 		    // refresh services at first
 		    ServiceManager::Services services(service_manager.GetServices());
+		    ServiceManager::Services to_refresh;
 		    bool network_is_running = NetworkDetected();
 
 		    for_(srv_it, services.begin(), services.end())
 		    {
+			if (srv_it->enabled() && srv_it->autorefresh())
+			{
+			    zypp::Url url(srv_it->url());
+
+			    if (!network_is_running && remoteRepo(url))
+			    {
+				y2warning("No network connection, skipping autorefresh of remote service %s (%s)",
+				    srv_it->alias().c_str(), url.asString().c_str());
+			    }
+			    else
+			    {
+				to_refresh.push_back(*srv_it);
+			    }
+			}
+		    }
+
+		    std::set<std::string> refreshed;
+		    // the refresh failed in the child, the error has been already reported
+		    std::set<std::string> failed;
+
+		    if (!RefreshServicesParallel(to_refresh, refreshed, failed))
+			success = false;
+
+		    if (!refreshed.empty())
+		    {
+			// the services have been refreshed by the child processes
+			repomanager = ReloadRepoManager();
+
+			for_(srv_it, refreshed.begin(), refreshed.end())
+			{
+			    service_manager.ReloadService(*srv_it, *repomanager);
+			}
+		    }
+
+		    // refresh the rest sequentially (not started or crashed children),
+		    // retrying the failed ones would wait for the same timeouts again
+		    for_(srv_it, to_refresh.begin(), to_refresh.end())
+		    {
+			if (refreshed.find(srv_it->alias()) != refreshed.end() || failed.find(srv_it->alias()) != failed.end())
+			    continue;
+
 			try
 			{
-			    if (srv_it->enabled() && srv_it->autorefresh())
+			    y2milestone("Autorefreshing service %s (%s)...", srv_it->alias().c_str(), srv_it->url().asString().c_str());
+
+			    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			    long long start_bytes = transfer_stats.bytes();
+
 			    {
-				zypp::Url url(srv_it->url());
-
-				if (!network_is_running && remoteRepo(url))
-				{
-				    y2warning("No network connection, skipping autorefresh of remote service %s (%s)",
-					srv_it->alias().c_str(), url.asString().c_str());
-				}
-				else
-				{
-				    y2milestone("Autorefreshing service %s (%s)...", srv_it->alias().c_str(), url.asString().c_str());
-				    service_manager.RefreshService(srv_it->alias(), *repomanager);
-				}
+				LoadStats::Timer timer(load_stats, srv_it->alias(), LoadStats::Download);
+				service_manager.RefreshService(srv_it->alias(), *repomanager);
 			    }
+
+			    load_stats.addDownloaded(srv_it->alias(), transfer_stats.bytes() - start_bytes);
+			    y2milestone("Service %s refreshed in %.3fs", srv_it->alias().c_str(),
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
 			}
 			catch (const zypp::Exception& excpt)
 			{
@@ -125,7 +183,7 @@ PkgFunctions::SourceRestore()
 	for (std::list<zypp::RepoInfo>::iterator it = reps.begin();
 	    it != reps.end(); ++it)
 	{
-	    repos.push_back(new YRepo(*it));
+	    repos.push_back(new YRepo(*it, false));
 	}
         _source_loaded = true;
     }
@@ -150,6 +208,11 @@ PkgFunctions::SourceRestore()
  **/
 YCPValue
 PkgFunctions::SourceLoad()
+{
+    return YCPBoolean(SourceLoadInternal());
+}
+
+bool PkgFunctions::SourceLoadInternal()
 {
     std::list<std::string> stages;
     stages.push_back(_("Refresh Sources"));
@@ -161,36 +224,887 @@ PkgFunctions::SourceLoad()
     // 3 steps per repository (download, cache rebuild, load resolvables)
     pkgprogress.Start(_("Loading the Package Manager..."), stages, _(HelpTexts::load_resolvables));
 
-    YCPValue ret = SourceLoadImpl(pkgprogress);
+    bool ret = SourceLoadImpl(pkgprogress);
 
     pkgprogress.Done();
 
     return ret;
 }
 
+/**
+ * @builtin SourceLoadOptions
+ *
+ * @short Set the options for loading the repositories
+ * @description
+ * The options are used by the next SourceRestore(), SourceLoad() and SourceStartManager() calls.
+ *
+ * Supported keys:
+ * "parallel_refresh" (integer) - the max. number of remote repositories refreshed
+ *   at once (default: 1 = refresh the repositories sequentially).
+ *   The repositories are refreshed in separate processes without any user interaction
+ *   (e.g. no authentication or GPG key import dialogs), a failed refresh is reported
+ *   as an error and the repository is not loaded, it is not refreshed again.
+ *   These downloads are not included in DownloadStats().
+ *   The same limit is used for refreshing the services in SourceRestore(), the services
+ *   are refreshed sequentially if the repositories have been already read (e.g. added
+ *   before SourceRestore()), reloading them from disk would drop the unsaved changes.
+ * "parallel_build" (integer) - the max. number of solv caches built at once,
+ *   0 = use the number of CPUs limited by the available memory (default),
+ *   1 = build the caches sequentially.
+ * "pipeline" (boolean) - load a remote repository into the pool as soon as it is
+ *   refreshed and its cache is built while the other repositories are still
+ *   being downloaded (default: true), used only when "parallel_refresh" is > 1.
+ * "skip_srcpackages" (boolean) - do not load the source repositories (default: false),
+ *   the repositories are recognized by the "source" content keyword in the repository
+ *   metadata or by the "source" word in the alias or the name ("repo-source", "SLES-Source-Pool")
+ * "skip_debuginfo" (boolean) - do not load the debuginfo repositories (default: false),
+ *   the repositories are recognized by the "debug" content keyword or by the "debug"
+ *   or "debuginfo" word in the alias or the name ("repo-debug-update", "SLES-Debuginfo-Pool"),
+ *   skipping them saves a lot of memory, see PoolStats().
+ * "rank_mirrors" (boolean) - for the repositories with several base URLs measure
+ *   the latency of the servers (in parallel) and use the nearest server first
+ *   for refreshing and downloading the packages (default: false),
+ *   the order is used only in memory, the configured order is kept in the saved
+ *   repository (and in SourceGeneralData()). The servers are not measured when
+ *   a proxy is used for them, the proxy connection says nothing about the server.
+ * "rank_mirrors_ttl" (integer) - how long the measured latency is valid (in seconds, default: 600)
+ *
+ * @param map options the options to set
+ * @return boolean true on success
+ **/
+YCPValue
+PkgFunctions::SourceLoadOptions(const YCPMap &options)
+{
+    const char *key = "parallel_refresh";
+    if(!options->value(YCPString(key)).isNull())
+    {
+	const YCPValue val = options->value(YCPString(key));
+	if (val->isInteger() && val->asInteger()->value() > 0)
+	{
+	    load_options.parallel_refresh = val->asInteger()->value();
+	    y2milestone("new parallel_refresh value: %u", load_options.parallel_refresh);
+	}
+	else
+	{
+	    y2error("Expected positive integer value for '%s' key, found %s", key, val->toString().c_str());
+	    return YCPBoolean(false);
+	}
+    }
+
+    key = "parallel_build";
+    if(!options->value(YCPString(key)).isNull())
+    {
+	const YCPValue val = options->value(YCPString(key));
+	if (val->isInteger() && val->asInteger()->value() >= 0)
+	{
+	    load_options.parallel_build = val->asInteger()->value();
+	    y2milestone("new parallel_build value: %u", load_options.parallel_build);
+	}
+	else
+	{
+	    y2error("Expected non-negative integer value for '%s' key, found %s", key, val->toString().c_str());
+	    return YCPBoolean(false);
+	}
+    }
+
+    key = "pipeline";
+    if(!options->value(YCPString(key)).isNull())
+    {
+	const YCPValue val = options->value(YCPString(key));
+	if (val->isBoolean())
+	{
+	    load_options.pipeline = val->asBoolean()->value();
+	    y2milestone("new pipeline value: %s", load_options.pipeline ? "true" : "false");
+	}
+	else
+	{
+	    y2error("Expected boolean value for '%s' key, found %s", key, val->toString().c_str());
+	    return YCPBoolean(false);
+	}
+    }
+
+    key = "skip_srcpackages";
+    if(!options->value(YCPString(key)).isNull())
+    {
+	const YCPValue val = options->value(YCPString(key));
+	if (val->isBoolean())
+	{
+	    load_options.skip_srcpackages = val->asBoolean()->value();
+	    y2milestone("new skip_srcpackages value: %s", load_options.skip_srcpackages ? "true" : "false");
+	}
+	else
+	{
+	    y2error("Expected boolean value for '%s' key, found %s", key, val->toString().c_str());
+	    return YCPBoolean(false);
+	}
+    }
+
+    key = "skip_debuginfo";
+    if(!options->value(YCPString(key)).isNull())
+    {
+	const YCPValue val = options->value(YCPString(key));
+	if (val->isBoolean())
+	{
+	    load_options.skip_debuginfo = val->asBoolean()->value();
+	    y2milestone("new skip_debuginfo value: %s", load_options.skip_debuginfo ? "true" : "false");
+	}
+	else
+	{
+	    y2error("Expected boolean value for '%s' key, found %s", key, val->toString().c_str());
+	    return YCPBoolean(false);
+	}
+    }
+
+    key = "rank_mirrors";
+    if(!options->value(YCPString(key)).isNull())
+    {
+	const YCPValue val = options->value(YCPString(key));
+	if (val->isBoolean())
+	{
+	    load_options.rank_mirrors = val->asBoolean()->value();
+	    y2milestone("new rank_mirrors value: %s", load_options.rank_mirrors ? "true" : "false");
+	}
+	else
+	{
+	    y2error("Expected boolean value for '%s' key, found %s", key, val->toString().c_str());
+	    return YCPBoolean(false);
+	}
+    }
+
+    key = "rank_mirrors_ttl";
+    if(!options->value(YCPString(key)).isNull())
+    {
+	const YCPValue val = options->value(YCPString(key));
+	if (val->isInteger() && val->asInteger()->value() >= 0)
+	{
+	    mirror_rank.setTTL(val->asInteger()->value());
+	    y2milestone("new rank_mirrors_ttl value: %lld", val->asInteger()->value());
+	}
+	else
+	{
+	    y2error("Expected non-negative integer value for '%s' key, found %s", key, val->toString().c_str());
+	    return YCPBoolean(false);
+	}
+    }
+
+    return YCPBoolean(true);
+}
+
+void PkgFunctions::RankMirrors()
+{
+    std::list<zypp::Url> urls;
+    RepoCont ranked;
+    zypp::media::ProxyInfo proxy;
+
+    for (RepoCont::iterator it = repos.begin(); it != repos.end(); ++it)
+    {
+	const zypp::RepoInfo &info((*it)->repoInfo());
+
+	if (!LoadEnabled(*it) || info.baseUrlsSize() < 2)
+	    continue;
+
+	// the connection to the proxy would be measured instead of the server
+	if (proxy.enabled() && std::any_of(info.baseUrlsBegin(), info.baseUrlsEnd(),
+	    [&proxy](const zypp::Url &url) { return proxy.useProxyFor(url); }))
+	{
+	    y2milestone("Not ranking repository %s, a proxy is used", info.alias().c_str());
+	    continue;
+	}
+
+	urls.insert(urls.end(), info.baseUrlsBegin(), info.baseUrlsEnd());
+	ranked.push_back(*it);
+    }
+
+    if (ranked.empty())
+	return;
+
+    // probe all servers at once
+    mirror_rank.probe(urls);
+
+    for (RepoCont::iterator it = ranked.begin(); it != ranked.end(); ++it)
+    {
+	const zypp::RepoInfo &info((*it)->repoInfo());
+	zypp::RepoInfo::url_set current(info.baseUrlsBegin(), info.baseUrlsEnd());
+	zypp::RepoInfo::url_set sorted(mirror_rank.sort(current));
+
+	if (std::equal(sorted.begin(), sorted.end(), current.begin(),
+	    [](const zypp::Url &a, const zypp::Url &b) { return a.asCompleteString() == b.asCompleteString(); }))
+	{
+	    // the configured order
+	    sorted.clear();
+	}
+	else
+	{
+	    y2milestone("Using %s for repository %s", sorted.front().asString().c_str(), info.alias().c_str());
+	}
+
+	(*it)->setRankedUrls(sorted);
+    }
+}
+
+PkgFunctions::RepoCont PkgFunctions::RefreshCandidates()
+{
+    RepoCont candidates;
+
+    for (RepoCont::iterator it = repos.begin(); it != repos.end(); ++it)
+    {
+	const zypp::RepoInfo &repo = (*it)->repoInfo();
+
+	if (!LoadEnabled(*it) || (*it)->isLoaded() || repo.baseUrlsEmpty())
+	    continue;
+
+	// only the remote repositories, the local ones might need a media change
+	if (!remoteRepo(repo.url()))
+	    continue;
+
+	if (repo.autorefresh() || MetadataStatus(repo).empty())
+	    candidates.push_back(*it);
+    }
+
+    return candidates;
+}
+
+// refresh the repository if needed, runs in the child process,
+// on failure the error is sent to the parent and false is returned
+static bool refreshInChild(zypp::RepoManager *repomanager, const zypp::RepoInfo &repo)
+{
+    try
+    {
+	if (repomanager->checkIfToRefreshMetadata(repo, repo.url()) == zypp::RepoManager::REFRESH_NEEDED)
+	{
+	    y2milestone("Autorefreshing source: %s", repo.alias().c_str());
+	    repomanager->refreshMetadata(repo, zypp::RepoManager::RefreshIfNeeded);
+	}
+	else
+	{
+	    y2milestone("Skipping repository '%s' - refresh is not needed", repo.alias().c_str());
+	}
+    }
+    catch (const zypp::Exception& excpt)
+    {
+	y2error("Refreshing repository '%s' failed: %s", repo.alias().c_str(), excpt.asString().c_str());
+	// the same text as ExceptionAsString()
+	std::string error(excpt.asUserString());
+	if (excpt.historySize() > 0)
+	    error += "\n" + excpt.historyAsString();
+
+	ProcessPool::report(error);
+	return false;
+    }
+
+    return true;
+}
+
+// pass the bytes downloaded by a job to the parent (the message of a succeeded job)
+static void reportDownloaded(const TransferStats &stats, long long start)
+{
+    ProcessPool::report(std::to_string(stats.bytes() - start));
+}
+
+// the bytes downloaded by a succeeded job
+static long long downloadedInChild(const std::string &message)
+{
+    return ::atoll(message.c_str());
+}
+
+// report a finished step of a repository (done in a child process)
+static void stepDone(zypp::ProgressData &prog_total)
+{
+    zypp::CombinedProgressData subprogress(prog_total, 100);
+    zypp::ProgressData prog(100);
+    prog.sendTo(subprogress);
+    prog.toMax();
+}
+
+/**
+ * @builtin SourceLoadStats
+ *
+ * @short Statistics of loading the repositories
+ * @description
+ * Returns the time spent in the load phases of each repository since the last
+ * SourceRestore() start (the repositories loaded later by SourceLoad(), SourceCreate()
+ * and others are included as well). The services refreshed by SourceRestore()
+ * are included by the service alias ("download", "forked" and "download_bytes" only).
+ * The times are in milliseconds.
+ * "check" - checking whether the metadata are up to date,
+ * "download" - downloading the metadata, "build" - building the solv cache,
+ * "load" - loading the solv cache into the pool,
+ * "forked" - the time of the parallel jobs (refresh and cache build in a separate process),
+ * "download_bytes" - the size of the downloaded metadata (the transferred files),
+ * "solvables" - the number of the loaded solvables.
+ *
+ * @return map $[ "alias" : $[ "check" : integer, "download" : integer, "build" : integer,
+ *   "load" : integer, "forked" : integer, "download_bytes" : integer, "solvables" : integer ], ... ]
+ **/
+YCPValue
+PkgFunctions::SourceLoadStats()
+{
+    return load_stats.asYCPMap();
+}
+
+// is the keyword in the repomd content keywords, or is it a word of the alias
+// or the name? (e.g. "repo-debug-update", "SLES-Debuginfo-Pool"),
+// the URL path is not used ("/update/src/" might be a normal repository)
+static bool repoHasContent(const zypp::RepoInfo &repo, const std::string &content, const char *words[])
+{
+    if (repo.hasContent(content))
+	return true;
+
+    std::vector<std::string> parts;
+    zypp::str::split(zypp::str::toLower(repo.alias()), std::back_inserter(parts), "-_. ");
+    zypp::str::split(zypp::str::toLower(repo.name()), std::back_inserter(parts), "-_. ");
+
+    for (const char **it = words; *it; ++it)
+    {
+	if (std::find(parts.begin(), parts.end(), *it) != parts.end())
+	    return true;
+    }
+
+    return false;
+}
+
+bool PkgFunctions::LoadEnabled(const YRepo_Ptr &repo) const
+{
+    const zypp::RepoInfo &info = repo->repoInfo();
+
+    if (!info.enabled() || repo->isDeleted())
+	return false;
+
+    static const char *source_words[] = { "source", NULL };
+    static const char *debug_words[] = { "debug", "debuginfo", NULL };
+
+    if (load_options.skip_srcpackages && repoHasContent(info, "source", source_words))
+    {
+	y2debug("Skipping source repository %s", info.alias().c_str());
+	return false;
+    }
+
+    if (load_options.skip_debuginfo && repoHasContent(info, "debug", debug_words))
+    {
+	y2debug("Skipping debuginfo repository %s", info.alias().c_str());
+	return false;
+    }
+
+    return true;
+}
+
+/**
+ * @builtin PoolStats
+ *
+ * @short Memory statistics of the package pool
+ * @description
+ * Returns the size of the pool and the memory used by the process, and the
+ * repositories skipped by the "skip_srcpackages" and "skip_debuginfo" options
+ * (see SourceLoadOptions()) with the size of their solv caches (the approximate
+ * memory which would be needed for loading them).
+ *
+ * @return map $[ "solvables" : integer, "repositories" : integer, "rss" : integer (bytes),
+ *   "skipped_repositories" : list<string> (aliases), "skipped_bytes" : integer ]
+ **/
+YCPValue
+PkgFunctions::PoolStats()
+{
+    YCPMap ret;
+
+    zypp::sat::Pool pool(zypp::sat::Pool::instance());
+    ret->add(YCPString("solvables"), YCPInteger(pool.solvablesSize()));
+    ret->add(YCPString("repositories"), YCPInteger(pool.reposSize()));
+
+    // resident set size, the second value in /proc/self/statm (in pages)
+    long long size = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (statm >> size >> resident)
+	ret->add(YCPString("rss"), YCPInteger(resident * ::sysconf(_SC_PAGESIZE)));
+
+    YCPList skipped;
+    long long skipped_bytes = 0;
+    zypp::Pathname solv_cache(GetRepoManagerOptions(_target_root, repo_target_distro).repoSolvCachePath);
+
+    for (RepoCont::const_iterator it = repos.begin(); it != repos.end(); ++it)
+    {
+	const zypp::RepoInfo &repo = (*it)->repoInfo();
+
+	if (repo.enabled() && !(*it)->isDeleted() && !(*it)->isLoaded() && !LoadEnabled(*it))
+	{
+	    skipped->add(YCPString(repo.alias()));
+
+	    zypp::PathInfo solv(solv_cache / repo.escaped_alias() / "solv");
+	    if (solv.isFile())
+		skipped_bytes += solv.size();
+	}
+    }
+
+    ret->add(YCPString("skipped_repositories"), skipped);
+    ret->add(YCPString("skipped_bytes"), YCPInteger(skipped_bytes));
+
+    return ret;
+}
+
+bool PkgFunctions::RefreshParallel(zypp::ProgressData &prog_total, RepoCont &refreshed, RepoCont &failed)
+{
+    if (load_options.parallel_refresh < 2)
+	return false;
+
+    zypp::RepoManager* repomanager = CreateRepoManager();
+    RepoCont candidates(RefreshCandidates());
+
+    if (candidates.size() < 2)
+    {
+	y2debug("Not enough repositories for parallel refresh: %zu", candidates.size());
+	return false;
+    }
+
+    y2milestone("Refreshing %zu repositories in parallel (max. %u at once)",
+	candidates.size(), load_options.parallel_refresh);
+
+    CallRefreshStarted();
+    CallInitDownload(_("Refreshing repositories"));
+
+    ProcessPool pool(load_options.parallel_refresh);
+
+    for (RepoCont::iterator it = candidates.begin(); it != candidates.end(); ++it)
+    {
+	zypp::RepoInfo repo((*it)->rankedRepoInfo());
+
+	// runs in the child process
+	pool.add(repo.alias(), [this, repomanager, repo] {
+	    long long start = transfer_stats.bytes();
+
+	    if (!refreshInChild(repomanager, repo))
+		return false;
+
+	    reportDownloaded(transfer_stats, start);
+	    return true;
+	});
+    }
+
+    pool.run([&](size_t index, ProcessPool::Result result) {
+	if (result == ProcessPool::Succeeded)
+	{
+	    refreshed.push_back(candidates[index]);
+
+	    RefreshedInChild(candidates[index]->repoInfo(), pool.duration(index), downloadedInChild(pool.message(index)));
+
+	    // the refresh step of the repository is done
+	    stepDone(prog_total);
+	}
+	// retrying the refresh would wait for the same timeouts again,
+	// only a crashed child is processed again sequentially
+	else if (result == ProcessPool::Failed && !pool.message(index).empty())
+	{
+	    failed.push_back(candidates[index]);
+	    RefreshFailedInChild(candidates[index]->repoInfo(), pool.message(index));
+	    stepDone(prog_total);
+	}
+
+	// SkipRefresh() might be called from a progress callback
+	return !autorefresh_skipped;
+    });
+
+    CallDestDownload();
+
+    y2milestone("Refreshed %zu repositories in parallel, %zu failed, %zu will be refreshed sequentially",
+	refreshed.size(), failed.size(), candidates.size() - refreshed.size() - failed.size());
+
+    return true;
+}
+
+// the number of caches which can be built at once,
+// limited by the number of CPUs and the available memory
+static unsigned parallelBuildLimit()
+{
+    long cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned ret = cpus > 0 ? cpus : 1;
+
+    // a repo2solv conversion of a big repository (e.g. OSS) needs about 256MiB
+    const unsigned long long memory_per_build = 256ULL << 20;
+
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    unsigned long long value;
+    std::string unit;
+
+    while (meminfo >> key >> value >> unit)
+    {
+	if (key == "MemAvailable:")
+	{
+	    unsigned long long by_memory = (value << 10) / memory_per_build;
+	    if (by_memory < ret)
+		ret = by_memory > 0 ? by_memory : 1;
+
+	    break;
+	}
+    }
+
+    y2debug("Parallel cache build limit: %u (CPUs: %ld)", ret, cpus);
+    return ret;
+}
+
+void PkgFunctions::BuildCacheParallel(zypp::ProgressData &prog_total, RepoCont &built)
+{
+    unsigned limit = load_options.parallel_build > 0 ? load_options.parallel_build : parallelBuildLimit();
+
+    if (limit < 2)
+	return;
+
+    zypp::RepoManager* repomanager = CreateRepoManager();
+    RepoCont candidates;
+
+    for (RepoCont::iterator it = repos.begin(); it != repos.end(); ++it)
+    {
+	const zypp::RepoInfo &repo = (*it)->repoInfo();
+
+	if (!LoadEnabled(*it) || (*it)->isLoaded() || !repo.autorefresh())
+	    continue;
+
+	zypp::RepoStatus raw_metadata_status = MetadataStatus(repo);
+
+	// missing metadata, reported in the sequential loop
+	if (raw_metadata_status.empty())
+	    continue;
+
+	// skip the up to date caches
+	if (repomanager->isCached(repo) && repomanager->cacheStatus(repo) == raw_metadata_status)
+	    continue;
+
+	candidates.push_back(*it);
+    }
+
+    if (candidates.size() < 2)
+    {
+	y2debug("Not enough repositories for parallel cache build: %zu", candidates.size());
+	return;
+    }
+
+    y2milestone("Building %zu caches in parallel (max. %u at once)", candidates.size(), limit);
+
+    ProcessPool pool(limit);
+
+    for (RepoCont::iterator it = candidates.begin(); it != candidates.end(); ++it)
+    {
+	zypp::RepoInfo repo((*it)->repoInfo());
+
+	// runs in the child process
+	pool.add(repo.alias(), [repomanager, repo] {
+	    y2milestone("Rebuilding cache for '%s'...", repo.alias().c_str());
+	    repomanager->buildCache(repo, zypp::RepoManager::BuildIfNeeded);
+	    return true;
+	});
+    }
+
+    pool.run([&](size_t index, ProcessPool::Result result) {
+	if (result == ProcessPool::Succeeded)
+	{
+	    built.push_back(candidates[index]);
+	    load_stats.add(candidates[index]->repoInfo().alias(), LoadStats::Forked, pool.duration(index));
+
+	    // the rebuild step of the repository is done
+	    stepDone(prog_total);
+	}
+
+	return !autorefresh_skipped;
+    });
+
+    y2milestone("Built %zu caches in parallel, %zu will be built sequentially",
+	built.size(), candidates.size() - built.size());
+}
+
+bool PkgFunctions::LoadPipeline(zypp::ProgressData &prog_total, RepoCont &loaded, RepoCont &prepared, RepoCont &failed, bool &success)
+{
+    if (load_options.parallel_refresh < 2 || !load_options.pipeline)
+	return false;
+
+    zypp::RepoManager* repomanager = CreateRepoManager();
+    RepoCont candidates(RefreshCandidates());
+
+    if (candidates.size() < 2)
+    {
+	y2debug("Not enough repositories for the load pipeline: %zu", candidates.size());
+	return false;
+    }
+
+    y2milestone("Loading %zu repositories in pipeline (max. %u downloads at once)",
+	candidates.size(), load_options.parallel_refresh);
+
+    CallRefreshStarted();
+    CallInitDownload(_("Refreshing repositories"));
+
+    ProcessPool pool(load_options.parallel_refresh);
+
+    for (RepoCont::iterator it = candidates.begin(); it != candidates.end(); ++it)
+    {
+	zypp::RepoInfo repo((*it)->rankedRepoInfo());
+
+	// runs in the child process, the cache is built right after the download
+	// so the download of the next repository overlaps with it
+	pool.add(repo.alias(), [this, repomanager, repo] {
+	    long long start = transfer_stats.bytes();
+
+	    if (!refreshInChild(repomanager, repo))
+		return false;
+
+	    y2milestone("Rebuilding cache for '%s'...", repo.alias().c_str());
+	    repomanager->buildCache(repo, zypp::RepoManager::BuildIfNeeded);
+
+	    // only on success, a failure message is an error text
+	    reportDownloaded(transfer_stats, start);
+	    return true;
+	});
+    }
+
+    // the repositories to load in the "repos" order: the candidate index or -1
+    // (the pool is not thread safe, loading is done here in the parent process)
+    std::vector<int> order;
+    for (RepoCont::iterator it = repos.begin(); it != repos.end(); ++it)
+    {
+	if (!LoadEnabled(*it) || (*it)->isLoaded())
+	    continue;
+
+	RepoCont::iterator cand = find(candidates.begin(), candidates.end(), *it);
+	order.push_back(cand == candidates.end() ? -1 : int(cand - candidates.begin()));
+    }
+
+    // the finished jobs, the successfully refreshed and built repositories
+    std::vector<bool> done(candidates.size(), false);
+    std::vector<bool> ready(candidates.size(), false);
+    size_t next_load = 0;
+
+    // load the consecutive finished repositories
+    auto load_finished = [&] {
+	for (; next_load < order.size(); ++next_load)
+	{
+	    int index = order[next_load];
+
+	    // a repository processed sequentially (not a candidate, crashed child
+	    // or a failed cache build) must be loaded first to keep the order
+	    if (index < 0 || !done[index])
+		break;
+
+	    if (!ready[index])
+	    {
+		// the refresh has failed (reported), the repository is not loaded
+		if (find(failed.begin(), failed.end(), candidates[index]) != failed.end())
+		    continue;
+
+		break;
+	    }
+
+	    YRepo_Ptr repo = candidates[index];
+	    y2milestone("Loading '%s' from the pipeline", repo->repoInfo().alias().c_str());
+
+	    zypp::CombinedProgressData load_subprogress(prog_total, 100);
+	    // the error is reported, the repository is not processed again
+	    if (!LoadResolvablesFrom(repo, load_subprogress, true))
+		success = false;
+
+	    loaded.push_back(repo);
+	}
+    };
+
+    pool.run([&](size_t index, ProcessPool::Result result) {
+	done[index] = true;
+
+	if (result == ProcessPool::Succeeded)
+	{
+	    ready[index] = true;
+	    RefreshedInChild(candidates[index]->repoInfo(), pool.duration(index), downloadedInChild(pool.message(index)));
+
+	    // the refresh and rebuild steps are done
+	    stepDone(prog_total);
+	    stepDone(prog_total);
+	}
+	// the refresh has failed (the error is reported by the child), do not retry it,
+	// the rest (a failed cache build, a crashed child) is processed again sequentially
+	else if (result == ProcessPool::Failed && !pool.message(index).empty())
+	{
+	    failed.push_back(candidates[index]);
+	    RefreshFailedInChild(candidates[index]->repoInfo(), pool.message(index));
+
+	    // the refresh step is done
+	    stepDone(prog_total);
+	}
+
+	load_finished();
+
+	// SkipRefresh() might be called from a progress callback
+	return !autorefresh_skipped;
+    });
+
+    // the already downloaded repositories are loaded even after skipping the refresh
+    load_finished();
+
+    // the rest is loaded later in the order
+    for (size_t index = 0; index < candidates.size(); ++index)
+    {
+	if (ready[index] && find(loaded.begin(), loaded.end(), candidates[index]) == loaded.end())
+	    prepared.push_back(candidates[index]);
+    }
+
+    CallDestDownload();
+
+    y2milestone("Loaded %zu repositories in pipeline, %zu prepared, %zu failed, %zu will be processed sequentially",
+	loaded.size(), prepared.size(), failed.size(), candidates.size() - loaded.size() - prepared.size() - failed.size());
+
+    return true;
+}
+
+void PkgFunctions::MemoizeMetadataStatus()
+{
+    // computed on demand, the raw metadata of a repository are read only once during the load
+    metadata_status.clear();
+    metadata_status_memo = true;
+}
+
+void PkgFunctions::ClearMetadataStatus()
+{
+    metadata_status.clear();
+    metadata_status_memo = false;
+}
+
+zypp::RepoStatus PkgFunctions::MetadataStatus(const zypp::RepoInfo &repo)
+{
+    if (metadata_status_memo)
+    {
+	std::map<std::string, zypp::RepoStatus>::const_iterator it = metadata_status.find(repo.alias());
+
+	if (it != metadata_status.end())
+	    return it->second;
+    }
+
+    zypp::RepoStatus ret = CreateRepoManager()->metadataStatus(repo);
+
+    if (metadata_status_memo)
+	metadata_status[repo.alias()] = ret;
+
+    return ret;
+}
+
+void PkgFunctions::InvalidateMetadataStatus(const std::string &alias)
+{
+    metadata_status.erase(alias);
+}
+
+void PkgFunctions::RefreshedInChild(const zypp::RepoInfo &repo, double duration, long long downloaded)
+{
+    InvalidateMetadataStatus(repo.alias());
+
+    load_stats.add(repo.alias(), LoadStats::Forked, duration);
+    load_stats.addDownloaded(repo.alias(), downloaded);
+}
+
+void PkgFunctions::RefreshFailedInChild(const zypp::RepoInfo &repo, const std::string &error)
+{
+    y2error("Error in SourceLoad: refreshing '%s' failed: %s", repo.alias().c_str(), error.c_str());
+
+    InvalidateMetadataStatus(repo.alias());
+
+    if (!autorefresh_skipped)
+	_last_error.setLastError(error);
+}
+
+bool PkgFunctions::RefreshServicesParallel(const ServiceManager::Services &services, std::set<std::string> &refreshed, std::set<std::string> &failed)
+{
+    if (load_options.parallel_refresh < 2 || services.size() < 2)
+	return true;
+
+    // the repositories read from disk would be lost by reloading the repository manager
+    if (!repos.empty())
+    {
+	y2milestone("%zu repositories already read, refreshing the services sequentially", repos.size());
+	return true;
+    }
+
+    y2milestone("Refreshing %zu services in parallel (max. %u at once)",
+	services.size(), load_options.parallel_refresh);
+
+    zypp::RepoManager* repomanager = CreateRepoManager();
+    ProcessPool pool(load_options.parallel_refresh);
+    std::vector<std::string> aliases;
+    std::vector<zypp::ServiceInfo> infos(services.begin(), services.end());
+    bool success = true;
+
+    for_(srv_it, services.begin(), services.end())
+    {
+	std::string alias(srv_it->alias());
+	aliases.push_back(alias);
+
+	// runs in the child process, the refreshed service and its repositories
+	// are written to disk, on failure the error is sent to the parent
+	pool.add(alias, [this, repomanager, alias] {
+	    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	    long long start_bytes = transfer_stats.bytes();
+
+	    try
+	    {
+		if (!service_manager.RefreshService(alias, *repomanager))
+		    return false;
+	    }
+	    catch (const zypp::Exception& excpt)
+	    {
+		y2error("Error in service refresh: %s", excpt.asString().c_str());
+		ProcessPool::report(ExceptionAsString(excpt));
+		return false;
+	    }
+
+	    y2milestone("Service %s refreshed in %.3fs", alias.c_str(),
+		std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+	    reportDownloaded(transfer_stats, start_bytes);
+	    return true;
+	});
+    }
+
+    pool.run([&](size_t index, ProcessPool::Result result) {
+	if (result == ProcessPool::Succeeded)
+	{
+	    refreshed.insert(aliases[index]);
+
+	    load_stats.add(aliases[index], LoadStats::Forked, pool.duration(index));
+	    load_stats.addDownloaded(aliases[index], downloadedInChild(pool.message(index)));
+	}
+	// the same error as in the sequential refresh, only a crashed child is processed again
+	else if (result == ProcessPool::Failed && !pool.message(index).empty())
+	{
+	    failed.insert(aliases[index]);
+
+	    const zypp::ServiceInfo &srv(infos[index]);
+	    _last_error.setLastError(std::string(_("Error refreshing service")) + " " + srv.name() + " ("
+		+ srv.url().asString() + "):\n\n" + pool.message(index));
+	    success = false;
+	}
+
+	return true;
+    });
+
+    y2milestone("Refreshed %zu services in parallel, %zu failed, %zu will be refreshed sequentially",
+	refreshed.size(), failed.size(), services.size() - refreshed.size() - failed.size());
+
+    return success;
+}
+
 void PkgFunctions::CallRefreshStarted()
 {
-    // get the YCP callback handler for destroy event
-    Y2Function* ycp_handler = _callbackHandler._ycpCallbacks.createCallback(CallbackHandler::YCPCallbacks::CB_StartSourceRefresh);
+    // deliver the pending progress events first
+    _callbackHandler._ycpCallbacks.flushEvents();
 
     // is the callback registered?
-    if (ycp_handler != NULL)
+    if (_callbackHandler._ycpCallbacks.isSet(CallbackHandler::YCPCallbacks::CB_StartSourceRefresh))
     {
 	// evaluate the callback function
-	ycp_handler->evaluateCall();
+	_callbackHandler._ycpCallbacks.call(CallbackHandler::YCPCallbacks::CB_StartSourceRefresh);
     }
 }
 
 void PkgFunctions::CallRefreshDone()
 {
-    // get the YCP callback handler for destroy event
-    Y2Function* ycp_handler = _callbackHandler._ycpCallbacks.createCallback(CallbackHandler::YCPCallbacks::CB_DoneSourceRefresh);
+    // deliver the pending progress events first
+    _callbackHandler._ycpCallbacks.flushEvents();
 
     // is the callback registered?
-    if (ycp_handler != NULL)
+    if (_callbackHandler._ycpCallbacks.isSet(CallbackHandler::YCPCallbacks::CB_DoneSourceRefresh))
     {
 	// evaluate the callback function
-	ycp_handler->evaluateCall();
+	_callbackHandler._ycpCallbacks.call(CallbackHandler::YCPCallbacks::CB_DoneSourceRefresh);
     }
 }
 
@@ -200,7 +1114,7 @@ YCPValue PkgFunctions::SkipRefresh()
     return YCPVoid();
 }
 
-YCPValue
+bool
 PkgFunctions::SourceLoadImpl(PkgProgress &progress)
 {
     bool success = true;
@@ -210,7 +1124,7 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
     for (RepoCont::iterator it = repos.begin();
        it != repos.end(); ++it)
     {
-	if ((*it)->repoInfo().enabled() && !(*it)->isDeleted())
+	if (LoadEnabled(*it))
 	{
 	    repos_to_load++;
 
@@ -235,19 +1149,75 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
     bool refresh_started_called = false;
     bool network_is_running = NetworkDetected();
 
+    if (load_options.rank_mirrors && network_is_running)
+	RankMirrors();
+
+    // memoize the metadata status until the end of the load
+    struct MetadataStatusMemo
+    {
+	MetadataStatusMemo(PkgFunctions &pkg) : _pkg(pkg) { _pkg.MemoizeMetadataStatus(); }
+	~MetadataStatusMemo() { _pkg.ClearMetadataStatus(); }
+	PkgFunctions &_pkg;
+    } metadata_status_memo_guard(*this);
+
+    // time spent in the stages (for the log)
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point stage_start = Clock::now();
+    Clock::time_point load_start = stage_start;
+    double time_pipeline = 0.0, time_refresh = 0.0, time_rebuild = 0.0;
+
     // remember failed repositories during autorefresh,
     // don't load packages from them
     RepoCont failed_refresh;
 
-    if (repos_to_refresh > 0)
+    // the repositories refreshed in parallel
+    RepoCont refreshed_parallel;
+    // the repositories refreshed and loaded in the pipeline
+    RepoCont loaded_pipeline;
+    // the repositories refreshed and built in the pipeline, loaded later in the order
+    RepoCont prepared_pipeline;
+
+    if (repos_to_refresh > 0 && network_is_running)
     {
-	// refresh metadata
+	refresh_started_called = LoadPipeline(prog_total, loaded_pipeline, prepared_pipeline, failed_refresh, success);
+
+	// the steps of the processed repositories have been already reported
+	refreshed_parallel = loaded_pipeline;
+	refreshed_parallel.insert(refreshed_parallel.end(), prepared_pipeline.begin(), prepared_pipeline.end());
+
+	Clock::time_point now = Clock::now();
+	time_pipeline = std::chrono::duration<double>(now - stage_start).count();
+	stage_start = now;
+
+	if (!refresh_started_called)
+	    refresh_started_called = RefreshParallel(prog_total, refreshed_parallel, failed_refresh);
+
+	// the errors have been reported by RefreshFailedInChild()
+	if (!failed_refresh.empty() && !autorefresh_skipped)
+	    success = false;
+    }
+
+    if (repos_to_refresh > 0 && !autorefresh_skipped)
+    {
+	// refresh metadata (the rest or the failed ones)
 	for (RepoCont::iterator it = repos.begin();
 	   it != repos.end(); ++it)
 	{
 	    // load resolvables only from enabled repos which are not deleted
-	    if ((*it)->repoInfo().enabled() && !(*it)->isDeleted())
+	    if (LoadEnabled(*it))
 	    {
+		if (find(refreshed_parallel.begin(), refreshed_parallel.end(), *it) != refreshed_parallel.end())
+		{
+		    y2debug("Repository '%s' has been already refreshed", (*it)->repoInfo().alias().c_str());
+		    continue;
+		}
+
+		if (find(failed_refresh.begin(), failed_refresh.end(), *it) != failed_refresh.end())
+		{
+		    y2debug("Repository '%s' has already failed to refresh", (*it)->repoInfo().alias().c_str());
+		    continue;
+		}
+
 		// sub tasks
 		zypp::CombinedProgressData refresh_subprogress(prog_total, 100);
 		zypp::ProgressData prog(100);
@@ -260,7 +1230,7 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
 		}
 		else
 		{
-		    zypp::RepoStatus raw_metadata_status = repomanager->metadataStatus((*it)->repoInfo());
+		    zypp::RepoStatus raw_metadata_status = MetadataStatus((*it)->repoInfo());
 
 		    // autorefresh the source
 		    if ((*it)->repoInfo().autorefresh() || raw_metadata_status.empty())
@@ -299,7 +1269,14 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
                     continue;
                 }
 
-			    zypp::RepoManager::RefreshCheckStatus ref_stat = repomanager->checkIfToRefreshMetadata((*it)->repoInfo(), (*it)->repoInfo().url());
+			    zypp::RepoManager::RefreshCheckStatus ref_stat;
+
+			    {
+				LoadStats::Timer timer(load_stats, (*it)->repoInfo().alias(), LoadStats::Check);
+				// the nearest server first (if ranked)
+				zypp::RepoInfo ranked((*it)->rankedRepoInfo());
+				ref_stat = repomanager->checkIfToRefreshMetadata(ranked, ranked.url());
+			    }
 
 			    if (ref_stat != zypp::RepoManager::REFRESH_NEEDED)
 			    {
@@ -309,7 +1286,16 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
 
 			    y2milestone("Autorefreshing source: %s", (*it)->repoInfo().alias().c_str());
 			    // refresh the repository
-			    RefreshWithCallbacks((*it)->repoInfo(), prog.receiver());
+			    InvalidateMetadataStatus((*it)->repoInfo().alias());
+
+			    long long start_bytes = transfer_stats.bytes();
+
+			    {
+				LoadStats::Timer timer(load_stats, (*it)->repoInfo().alias(), LoadStats::Download);
+				RefreshWithCallbacks((*it)->rankedRepoInfo(), prog.receiver());
+			    }
+
+			    load_stats.addDownloaded((*it)->repoInfo().alias(), transfer_stats.bytes() - start_bytes);
 			}
 			// NOTE: subtask progresses are reported as done in the destructor
 			// no need to handle them in the exception code
@@ -349,13 +1335,32 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
 
     progress.NextStage();
 
-    // rebuild cache
+    Clock::time_point now = Clock::now();
+    time_refresh = std::chrono::duration<double>(now - stage_start).count();
+    stage_start = now;
+
+    // the repositories with the cache built in parallel
+    RepoCont built_parallel(loaded_pipeline);
+    built_parallel.insert(built_parallel.end(), prepared_pipeline.begin(), prepared_pipeline.end());
+
+    if (!autorefresh_skipped)
+    {
+	BuildCacheParallel(prog_total, built_parallel);
+    }
+
+    // rebuild cache (the rest or the failed ones, to report the errors)
     for (RepoCont::iterator it = repos.begin();
        it != repos.end(); ++it)
     {
 	// load resolvables only from enabled repos which are not deleted
-	if ((*it)->repoInfo().enabled() && !(*it)->isDeleted())
+	if (LoadEnabled(*it))
 	{
+	    if (find(built_parallel.begin(), built_parallel.end(), *it) != built_parallel.end())
+	    {
+		y2debug("Cache for '%s' has been already built", (*it)->repoInfo().alias().c_str());
+		continue;
+	    }
+
 	    // sub tasks
 	    zypp::CombinedProgressData rebuild_subprogress(prog_total, 100);
 	    zypp::ProgressData prog(100);
@@ -371,7 +1376,7 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
 		// autorefresh the source
 		if ((*it)->repoInfo().autorefresh())
 		{
-		    zypp::RepoStatus raw_metadata_status = repomanager->metadataStatus((*it)->repoInfo());
+		    zypp::RepoStatus raw_metadata_status = MetadataStatus((*it)->repoInfo());
 
 		    // autorefresh the source
 		    if (raw_metadata_status.empty() )
@@ -385,6 +1390,7 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
 			// rebuild cache (the default policy is "if needed")
 			y2milestone("Rebuilding cache for '%s'...", (*it)->repoInfo().alias().c_str());
 
+			LoadStats::Timer timer(load_stats, (*it)->repoInfo().alias(), LoadStats::Build);
 			//repomanager->buildCache((*it)->repoInfo(), zypp::RepoManager::BuildIfNeeded, prog.receiver());
 			repomanager->buildCache((*it)->repoInfo(), zypp::RepoManager::BuildIfNeeded, rebuild_subprogress);
 		    }
@@ -428,12 +1434,21 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
 
     progress.NextStage();
 
+    load_start = Clock::now();
+    time_rebuild = std::chrono::duration<double>(load_start - stage_start).count();
+
     for (RepoCont::iterator it = repos.begin();
        it != repos.end(); ++it)
     {
 	// load resolvables only from enabled repos which are not deleted
-	if ((*it)->repoInfo().enabled() && !(*it)->isDeleted())
+	if (LoadEnabled(*it))
 	{
+	    if (find(loaded_pipeline.begin(), loaded_pipeline.end(), *it) != loaded_pipeline.end())
+	    {
+		y2debug("Repository '%s' has been loaded in the pipeline", (*it)->repoInfo().alias().c_str());
+		continue;
+	    }
+
 	    // check whether the refresh failed or not
 	    RepoCont::iterator failed_it = find(failed_refresh.begin(), failed_refresh.end(), *it);
 	    if (failed_it != failed_refresh.end())
@@ -463,8 +1478,13 @@ PkgFunctions::SourceLoadImpl(PkgProgress &progress)
     // report 100%
     prog_total.toMax();
 
+    y2milestone("SourceLoad stages: pipeline %.3fs (%zu repos), refresh %.3fs, rebuild %.3fs, load %.3fs",
+	time_pipeline, loaded_pipeline.size(), time_refresh, time_rebuild,
+	std::chrono::duration<double>(Clock::now() - load_start).count());
+    load_stats.log();
+
     autorefresh_skipped = false;
-    return YCPBoolean(success);
+    return success;
 }
 
 
@@ -530,7 +1550,7 @@ PkgFunctions::SourceStartManagerImpl(const YCPBoolean& enable, PkgProgress &prog
 	}
 
 	// enable all sources and load the resolvables
-	success = YCPBoolean(SourceLoadImpl(progress)->asBoolean()->value() && success->asBoolean()->value());
+	success = YCPBoolean(SourceLoadImpl(progress) && success->asBoolean()->value());
     }
 
     return success;
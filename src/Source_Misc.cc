@@ -87,6 +87,43 @@ PkgFunctions::RepoId PkgFunctions::logFindAlias(const std::string &alias) const
     return -1LL;
 }
 
+// scheme, host and path (without the query and the credentials)
+static std::string urlLocation(const zypp::Url &url)
+{
+    return url.getScheme() + "://" + url.getHost() + url.getPathName();
+}
+
+std::string PkgFunctions::AliasForUrl(const zypp::Url &url) const
+{
+    std::string location(urlLocation(url));
+    std::string ret;
+    size_t matched = 0;
+
+    // the repository with the longest matching base URL
+    for(RepoCont::const_iterator it = repos.begin(); it != repos.end() ; ++it)
+    {
+	if ((*it)->isDeleted())
+	    continue;
+
+	const zypp::RepoInfo &info((*it)->repoInfo());
+
+	for (zypp::RepoInfo::urls_const_iterator base = info.baseUrlsBegin(); base != info.baseUrlsEnd(); ++base)
+	{
+	    std::string prefix(urlLocation(*base));
+
+	    // match whole path components only ("/repo" does not match "/repo2")
+	    if (prefix.size() > matched && location.compare(0, prefix.size(), prefix) == 0
+		&& (location.size() == prefix.size() || location[prefix.size()] == '/' || *prefix.rbegin() == '/'))
+	    {
+		ret = info.alias();
+		matched = prefix.size();
+	    }
+	}
+    }
+
+    return ret;
+}
+
 bool PkgFunctions::aliasExists(const std::string &alias, const std::list<zypp::RepoInfo> &reps) const
 {
     // search in loaded repositories
@@ -61,7 +61,9 @@ bool PkgFunctions::LoadResolvablesFrom(YRepo_Ptr repo, const zypp::ProgressData:
 	return true;
     }
 
-    const zypp::RepoInfo &repoinfo = repo->repoInfo();
+    // the ranked URLs are stored in the pool repository,
+    // the packages are downloaded from the nearest server (commit, PackageProvider)
+    const zypp::RepoInfo repoinfo(repo->rankedRepoInfo());
     bool success = true;
     unsigned int size_start = zypp_ptr()->pool().size();
     y2milestone("Loading resolvables from '%s', pool size at start: %d", repoinfo.alias().c_str(), size_start);
@@ -79,7 +81,7 @@ bool PkgFunctions::LoadResolvablesFrom(YRepo_Ptr repo, const zypp::ProgressData:
 	// build cache if needed
 	if (!repomanager->isCached(repoinfo) && !autorefresh_skipped)
 	{
-	    zypp::RepoStatus raw_metadata_status = repomanager->metadataStatus(repoinfo);
+	    zypp::RepoStatus raw_metadata_status = MetadataStatus(repoinfo);
 	    if (raw_metadata_status.empty())
 	    {
 		if (network_check)
@@ -109,7 +111,14 @@ bool PkgFunctions::LoadResolvablesFrom(YRepo_Ptr repo, const zypp::ProgressData:
 
 		    CallRefreshStarted();
 
-		    RefreshWithCallbacks(repoinfo);
+		    long long start_bytes = transfer_stats.bytes();
+
+		    {
+			LoadStats::Timer timer(load_stats, repoinfo.alias(), LoadStats::Download);
+			RefreshWithCallbacks(repoinfo);
+		    }
+
+		    load_stats.addDownloaded(repoinfo.alias(), transfer_stats.bytes() - start_bytes);
 
 		    CallRefreshDone();
 		}
@@ -118,11 +127,16 @@ bool PkgFunctions::LoadResolvablesFrom(YRepo_Ptr repo, const zypp::ProgressData:
 	    if (refresh)
 	    {
 		y2milestone("Caching source '%s'...", repoinfo.alias().c_str());
+		LoadStats::Timer timer(load_stats, repoinfo.alias(), LoadStats::Build);
 		repomanager->buildCache(repoinfo, zypp::RepoManager::BuildIfNeeded, load_subprogress);
 	    }
 	}
 
-	repomanager->loadFromCache(repoinfo);
+	{
+	    LoadStats::Timer timer(load_stats, repoinfo.alias(), LoadStats::Load);
+	    repomanager->loadFromCache(repoinfo);
+	}
+
 	repo->setLoaded();
 	//y2milestone("Loaded %zd resolvables", store.size());
     }
@@ -158,6 +172,7 @@ bool PkgFunctions::LoadResolvablesFrom(YRepo_Ptr repo, const zypp::ProgressData:
 
     unsigned int size_end = zypp_ptr()->pool().size();
     y2milestone("Pool size at end: %d (loaded %d resolvables)", size_end, size_end - size_start);
+    load_stats.addSolvables(repoinfo.alias(), (long long)size_end - size_start);
 
     prog.toMax();
 
@@ -32,8 +32,13 @@
 #include "log.h"
 #include <PkgProgress.h>
 
+#include <zypp/PathInfo.h>
+
 #include <HelpTexts.h>
 
+#include <ftw.h>
+#include <unistd.h>
+
 /*
   Textdomain "pkg-bindings"
 */
@@ -47,12 +52,17 @@
  **/
 YCPValue
 PkgFunctions::SourceReleaseAll ()
+{
+    return YCPBoolean(SourceReleaseAllImpl());
+}
+
+bool PkgFunctions::SourceReleaseAllImpl()
 {
     y2milestone("Releasing all sources...");
     bool ret = true;
 
     y2milestone("Removing all tmp directories");
-    tmp_dirs.clear();
+    download_area.clear();
 
     for (RepoCont::iterator it = repos.begin();
 	it != repos.end(); ++it)
@@ -68,7 +78,26 @@ PkgFunctions::SourceReleaseAll ()
         }
     }
 
-    return YCPBoolean(ret);
+    return ret;
+}
+
+// remove a directory entry (the content first), used by nftw()
+static int remove_entry(const char *path, const struct stat *, int type, struct FTW *)
+{
+    if (type == FTW_DP)
+	::rmdir(path);
+    else
+	::unlink(path);
+
+    // continue with the rest on error
+    return 0;
+}
+
+// remove a directory tree, runs in a thread: only plain system calls,
+// libzypp and the logging are not thread safe
+static void remove_tree(const zypp::Pathname &dir)
+{
+    ::nftw(dir.c_str(), remove_entry, 16, FTW_DEPTH | FTW_PHYS);
 }
 
 /**
@@ -104,8 +133,9 @@ PkgFunctions::SourceSaveAll ()
 	ret = false;
     }
 
-    // count removed repos
+    // count removed and changed repos
     int removed_repos = 0;
+    int changed_repos = 0;
     for (RepoCont::iterator it = repos.begin();
 	it != repos.end(); ++it)
     {
@@ -114,15 +144,18 @@ PkgFunctions::SourceSaveAll ()
 	{
 	    removed_repos++;
 	}
+	else if ((*it)->isDirty())
+	{
+	    changed_repos++;
+	}
     }
 
-    y2debug("Found %d removed repositories", removed_repos);
+    y2milestone("Found %d removed and %d changed repositories (%zu total)", removed_repos, changed_repos, repos.size());
 
-    // number of steps:
-    //   for removed repository: 3 (remove metadata, remove from cache, remove .repo file)
-    //   for other repositories: 1 (just save/update .repo file)
-    //   (so there are 2 extra steps for removed repos)
-    int save_steps = 2*removed_repos + repos.size();
+    // number of steps: 1 for each removed repository (remove the .repo file,
+    // the data are removed in background) and for each changed repository
+    // (save/update the .repo file)
+    int save_steps = removed_repos + changed_repos;
 
     PkgProgress pkgprogress(_callbackHandler);
     std::list<std::string> stages;
@@ -144,6 +177,23 @@ PkgFunctions::SourceSaveAll ()
     // start the process
     pkgprogress.Start(_("Saving Repositories..."), stages, _(HelpTexts::save_help));
 
+    // the previous removal might be still running
+    JoinRepoCleanup();
+
+    // the directories to remove in background
+    std::vector<zypp::Pathname> to_remove;
+    zypp::Pathname solv_cache(GetRepoManagerOptions(_target_root, repo_target_distro).repoSolvCachePath);
+
+    auto start_cleanup = [&] {
+	if (to_remove.empty())
+	    return;
+
+	repo_cleanup = std::thread([to_remove] {
+	    for (std::vector<zypp::Pathname>::const_iterator it = to_remove.begin(); it != to_remove.end(); ++it)
+		remove_tree(*it);
+	});
+    };
+
     // remove deleted repos (the old configurations) at first
     for (RepoCont::iterator it = repos.begin();
 	it != repos.end(); ++it)
@@ -155,22 +205,29 @@ PkgFunctions::SourceSaveAll ()
 
 	    try
 	    {
-		// remove the metadata
-		zypp::RepoStatus raw_metadata_status = repomanager->metadataStatus((*it)->repoInfo());
-		if (!raw_metadata_status.empty())
-		{
-		    y2milestone("Removing metadata for source '%s'...", repo_alias.c_str());
-		    repomanager->cleanMetadata((*it)->repoInfo());
-		}
-		prog_total.incr();
+		// move the metadata and the cache away (fast), remove them later in background
+		std::vector<zypp::Pathname> data;
+		data.push_back(repomanager->metadataPath((*it)->repoInfo()));
+		data.push_back(solv_cache / (*it)->repoInfo().escaped_alias());
 
-		// remove the cache
-		if (repomanager->isCached((*it)->repoInfo()))
+		for (std::vector<zypp::Pathname>::const_iterator d = data.begin(); d != data.end(); ++d)
 		{
-		    y2milestone("Removing cache for '%s'...", repo_alias.c_str());
-		    repomanager->cleanCache((*it)->repoInfo());
+		    if (!zypp::PathInfo(*d).isDir())
+			continue;
+
+		    zypp::Pathname trash(d->extend(".yast-removed"));
+
+		    if (zypp::filesystem::rename(*d, trash) == 0)
+		    {
+			y2milestone("Removing %s in background", d->c_str());
+			to_remove.push_back(trash);
+		    }
+		    else
+		    {
+			y2milestone("Removing %s...", d->c_str());
+			zypp::filesystem::recursive_rmdir(*d);
+		    }
 		}
-		prog_total.incr();
 
 		// does the repository exist?
 		repomanager->getRepositoryInfo(repo_alias);
@@ -187,6 +244,7 @@ PkgFunctions::SourceSaveAll ()
 	    {
 		y2error("Pkg::SourceSaveAll has failed: %s", excpt.msg().c_str() );
 		_last_error.setLastError(ExceptionAsString(excpt));
+		start_cleanup();
 		return YCPBoolean(false);
 	    }
 	}
@@ -197,11 +255,13 @@ PkgFunctions::SourceSaveAll ()
 	pkgprogress.NextStage();
     }
 
-    // save all repos (the current configuration)
+    start_cleanup();
+
+    // save the changed repos (the current configuration)
     for (RepoCont::iterator it = repos.begin();
 	it != repos.end(); ++it)
     {
-	if (!(*it)->isDeleted())
+	if (!(*it)->isDeleted() && (*it)->isDirty())
 	{
 	    std::string current_alias = (*it)->repoInfo().alias();
 
@@ -220,6 +280,8 @@ PkgFunctions::SourceSaveAll ()
 		    y2milestone("Adding repository '%s'", current_alias.c_str());
 		    repomanager->addRepository((*it)->repoInfo());
 		}
+
+		(*it)->resetDirty();
 	    }
 	    catch (zypp::Exception & excpt)
 	    {
@@ -237,6 +299,15 @@ PkgFunctions::SourceSaveAll ()
     return YCPBoolean(ret);
 }
 
+void PkgFunctions::JoinRepoCleanup()
+{
+    if (repo_cleanup.joinable())
+    {
+	y2milestone("Waiting for removing the data of the deleted repositories...");
+	repo_cleanup.join();
+    }
+}
+
 /**
  * @builtin SourceFinishAll
  *
@@ -255,6 +326,8 @@ PkgFunctions::SourceFinishAll ()
     {
 	y2milestone( "Unregistering all sources...") ;
 
+	JoinRepoCleanup();
+
     	// remove all resolvables
 	for (RepoCont::iterator it = repos.begin();
 	    it != repos.end(); ++it)
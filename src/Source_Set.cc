@@ -64,6 +64,7 @@ PkgFunctions::SourceSetEnabled (const YCPInteger& id, const YCPBoolean& e)
     try
     {
 	repo->repoInfo().setEnabled(enable);
+	repo->setDirty();
 
 	// add/remove resolvables
 	if (enable)
@@ -119,6 +120,7 @@ PkgFunctions::SourceSetPriority(const YCPInteger& id, const YCPInteger& priority
     if (!repo) return YCPBoolean(false);
 
     repo->repoInfo().setPriority(priority->value());
+    repo->setDirty();
 
     // apply the priority also on the loaded packages in the pool (bsc#498266),
     zypp::Repository r(zypp::sat::Pool::instance().reposFind(repo->repoInfo().alias()));
@@ -153,6 +155,7 @@ PkgFunctions::SourceSetAutorefresh (const YCPInteger& id, const YCPBoolean& e)
 	return YCPBoolean(false);
 
     repo->repoInfo().setAutorefresh(e->value());
+    repo->setDirty();
 
     return YCPBoolean( true );
 }
@@ -205,6 +208,8 @@ PkgFunctions::SourceEditSet (const YCPList& states)
     }
 
     // now, we have the source
+    repo->setDirty();
+
     if( ! descr->value( YCPString("enabled")).isNull() && descr->value(YCPString("enabled"))->isBoolean ())
     {
 	bool enable = descr->value(YCPString("enabled"))->asBoolean ()->value();
@@ -293,6 +298,10 @@ PkgFunctions::SourceChangeUrl (const YCPInteger& id, const YCPString& u)
         }
         else
             repo->repoInfo().setBaseUrl(zypp::Url(u->value()));
+
+        // the ranking is not valid anymore
+        repo->setRankedUrls(zypp::RepoInfo::url_set());
+        repo->setDirty();
     }
     catch (const zypp::Exception & excpt)
     {
@@ -342,6 +351,7 @@ PkgFunctions::SourceRaisePriority (const YCPInteger& id)
 
 	// set the new priority
 	repo->repoInfo().setPriority(prio);
+	repo->setDirty();
     }
 
     return YCPBoolean(true);
@@ -378,6 +388,7 @@ PkgFunctions::SourceLowerPriority (const YCPInteger& id)
 
 	// set the new priority
 	repo->repoInfo().setPriority(prio);
+	repo->setDirty();
     }
 
     return YCPBoolean(true);
@@ -27,6 +27,7 @@
 
 #include <PkgFunctions.h>
 #include "log.h"
+#include "ProcessPool.h"
 
 #include <ycp/YCPBoolean.h>
 #include <ycp/YCPString.h>
@@ -151,21 +152,41 @@ PkgFunctions::TargetInitialize (const YCPString& root)
 YCPValue
 PkgFunctions::TargetInitializeOptions (const YCPString& root, const YCPMap& options)
 {
-    const std::string r = root->value();
+    std::string target_distro;
 
+    if (!options.isNull() && !options->value(YCPString("target_distro")).isNull()
+	&& options->value(YCPString("target_distro"))->isString())
+    {
+	target_distro = options->value(YCPString("target_distro"))->asString()->value();
+    }
+
+    std::string error;
+
+    if (!TargetInitializeImpl(root->value(), target_distro, &error))
+        return YCPError(error.c_str(), YCPBoolean(false));
+
+    return YCPBoolean(true);
+}
+
+bool PkgFunctions::TargetInitializeImpl(const std::string &root, const std::string &target_distro, std::string *error)
+{
     try
     {
-        zypp_ptr()->initializeTarget(r);
-        SetTarget(r, options);
+        zypp_ptr()->initializeTarget(root);
+        SetTarget(root, target_distro);
     }
     catch (zypp::Exception & excpt)
     {
         _last_error.setLastError(ExceptionAsString(excpt));
         y2error("TargetInit has failed: %s", excpt.msg().c_str() );
-        return YCPError(excpt.msg().c_str(), YCPBoolean(false));
+
+        if (error)
+            *error = excpt.msg();
+
+        return false;
     }
 
-    return YCPBoolean(true);
+    return true;
 }
 
 /** ------------------------
@@ -176,11 +197,21 @@ PkgFunctions::TargetInitializeOptions (const YCPString& root, const YCPMap& opti
  */
 YCPValue
 PkgFunctions::TargetLoad ()
+{
+    std::string error;
+
+    if (!TargetLoadImpl(&error))
+        return YCPError(error.c_str(), YCPBoolean(false));
+
+    return YCPBoolean(true);
+}
+
+bool PkgFunctions::TargetLoadImpl(std::string *error)
 {
     if (_target_loaded)
     {
 	y2milestone("The target system is already loaded");
-	return YCPBoolean(true);
+	return true;
     }
 
     std::list<std::string> stages;
@@ -199,12 +230,64 @@ PkgFunctions::TargetLoad ()
     {
         _last_error.setLastError(ExceptionAsString(excpt));
         y2error("TargetLoad has failed: %s", excpt.msg().c_str() );
-        return YCPError(excpt.msg().c_str(), YCPBoolean(false));
+
+        if (error)
+            *error = excpt.msg();
+
+        return false;
     }
 
     pkgprogress.Done();
 
-    return YCPBoolean(true);
+    return true;
+}
+
+/** ------------------------
+ *
+ * @builtin StartManagerAndTarget
+ * @short Initialize the target and load both the target and the repositories
+ * @description
+ * The same as TargetInitializeOptions(), SourceStartManager(true) and TargetLoad(),
+ * but the installed packages (the rpm database) are read into the solv cache
+ * in a separate process while the repositories are refreshed and loaded.
+ * The target is inserted into the pool after the repositories.
+ *
+ * @param string root Root Directory
+ * @param map options for RepoManager, see TargetInitializeOptions()
+ * @return boolean true on success
+ */
+YCPValue
+PkgFunctions::StartManagerAndTarget (const YCPString& root, const YCPMap& options)
+{
+    YCPValue ret = TargetInitializeOptions(root, options);
+
+    if (!ret->isBoolean() || !ret->asBoolean()->value())
+	return ret;
+
+    pid_t target_job = -1;
+
+    if (!_target_loaded)
+    {
+	// the cache is written to disk, loading it later is cheap
+	target_job = ProcessPool::spawn("target cache", [this] {
+	    y2milestone("Building the target cache...");
+	    zypp_ptr()->target()->buildCache();
+	    return true;
+	});
+    }
+
+    YCPValue sources = SourceStartManager(YCPBoolean(true));
+
+    if (target_job > 0 && ProcessPool::wait(target_job) != ProcessPool::Succeeded)
+    {
+	// not fatal, TargetLoad() builds the cache again and reports the error
+	y2warning("Building the target cache in background failed");
+    }
+
+    YCPValue target = TargetLoad();
+
+    return YCPBoolean(sources->isBoolean() && sources->asBoolean()->value()
+	&& target->isBoolean() && target->asBoolean()->value());
 }
 
 /** ------------------------
@@ -0,0 +1,124 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	TransferStats.cc
+   Summary:     Download statistics per repository and per server
+*/
+
+#include "TransferStats.h"
+#include "log.h"
+
+#include <ycp/YCPInteger.h>
+#include <ycp/YCPString.h>
+
+#include <zypp/PathInfo.h>
+
+void TransferStats::start(const zypp::Url &url, const zypp::Pathname &local, const std::string &alias)
+{
+    _alias = alias;
+    _host = url.getHost();
+    _local = local;
+    _start = std::chrono::steady_clock::now();
+    _peak = 0.0;
+}
+
+void TransferStats::progress(double bps_current)
+{
+    if (bps_current > _peak)
+	_peak = bps_current;
+}
+
+void TransferStats::finish(bool failed)
+{
+    // not started (e.g. a local file)
+    if (_host.empty())
+	return;
+
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    long long bytes = failed ? 0 : zypp::PathInfo(_local).size();
+
+    _bytes += bytes;
+
+    Entry *entries[2] = { _alias.empty() ? NULL : &_repositories[_alias], &_hosts[_host] };
+
+    for (unsigned i = 0; i < 2; ++i)
+    {
+	if (!entries[i])
+	    continue;
+
+	Entry &entry(*entries[i]);
+	++entry.transfers;
+	entry.bytes += bytes;
+	entry.time += time;
+
+	if (_peak > entry.peak)
+	    entry.peak = _peak;
+
+	if (failed)
+	    ++entry.failures;
+    }
+
+    _host.clear();
+    _alias.clear();
+}
+
+void TransferStats::retry()
+{
+    if (!_alias.empty())
+	++_repositories[_alias].retries;
+
+    if (!_host.empty())
+	++_hosts[_host].retries;
+}
+
+void TransferStats::reset()
+{
+    _repositories.clear();
+    _hosts.clear();
+}
+
+YCPMap TransferStats::statsMap(const Stats &stats)
+{
+    YCPMap ret;
+
+    for (Stats::const_iterator it = stats.begin(); it != stats.end(); ++it)
+    {
+	const Entry &e(it->second);
+	YCPMap entry;
+
+	entry->add(YCPString("transfers"), YCPInteger(e.transfers));
+	entry->add(YCPString("bytes"), YCPInteger(e.bytes));
+	entry->add(YCPString("time"), YCPInteger((long long)(e.time * 1000)));
+	entry->add(YCPString("avg_bps"), YCPInteger(e.time > 0 ? (long long)(e.bytes / e.time) : 0LL));
+	entry->add(YCPString("peak_bps"), YCPInteger((long long)e.peak));
+	entry->add(YCPString("retries"), YCPInteger(e.retries));
+	entry->add(YCPString("failures"), YCPInteger(e.failures));
+
+	ret->add(YCPString(it->first), entry);
+    }
+
+    return ret;
+}
+
+YCPMap TransferStats::asYCPMap() const
+{
+    YCPMap ret;
+    ret->add(YCPString("repositories"), statsMap(_repositories));
+    ret->add(YCPString("hosts"), statsMap(_hosts));
+    return ret;
+}
@@ -0,0 +1,109 @@
+/* ------------------------------------------------------------------------------
+ * Copyright (c) 2026 SUSE LLC. All Rights Reserved.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of version 2 of the GNU General Public License as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, contact SUSE LLC.
+ * ------------------------------------------------------------------------------
+ */
+
+/*
+   File:	TransferStats.h
+   Summary:     Download statistics per repository and per server
+*/
+
+#ifndef TransferStats_h
+#define TransferStats_h
+
+#include <map>
+#include <string>
+#include <chrono>
+
+#include <ycp/YCPMap.h>
+#include <zypp/Url.h>
+#include <zypp/Pathname.h>
+
+/**
+ * Collects the transferred bytes, the transfer time, the throughput,
+ * the retries and the failures of the downloads (reported by the download callbacks).
+ * The retries and the failures are counted per file (DownloadProgressReport),
+ * not per package, a failed package download is counted once.
+ * Only one download runs at once (libzypp is single threaded), the downloads
+ * in the forked processes (the parallel refresh, the commit pipeline) are not counted.
+ */
+class TransferStats
+{
+    public:
+
+	TransferStats() : _bytes(0), _peak(0.0) {}
+
+	// the repository of the following downloads (a package download), empty to reset
+	void setRepository(const std::string &alias) { _repository = alias; }
+
+	// a file download has been started
+	void start(const zypp::Url &url, const zypp::Pathname &local, const std::string &alias);
+
+	// the current speed in bytes per second
+	void progress(double bps_current);
+
+	// the download has been finished, "failed" is true on error
+	void finish(bool failed);
+
+	// the current download is going to be retried
+	void retry();
+
+	const std::string& repository() const { return _repository; }
+
+	// all transferred bytes since the start (not cleared by reset()),
+	// the difference measures the downloads of an operation
+	long long bytes() const { return _bytes; }
+
+	void reset();
+
+	// $[ "repositories" : $[ alias : stats ], "hosts" : $[ host : stats ] ], stats:
+	// $[ "transfers" : integer, "bytes" : integer, "time" : integer (ms), "avg_bps" : integer,
+	//    "peak_bps" : integer, "retries" : integer, "failures" : integer ]
+	YCPMap asYCPMap() const;
+
+    private:
+
+	struct Entry
+	{
+	    Entry() : transfers(0), bytes(0), time(0.0), peak(0.0), retries(0), failures(0) {}
+
+	    long long transfers;
+	    long long bytes;
+	    double time;
+	    double peak;
+	    long long retries;
+	    long long failures;
+	};
+
+	typedef std::map<std::string, Entry> Stats;
+
+	static YCPMap statsMap(const Stats &stats);
+
+	Stats _repositories;
+	Stats _hosts;
+	long long _bytes;
+
+	// the repository of the current package download
+	std::string _repository;
+
+	// the current file download
+	std::string _alias;
+	std::string _host;
+	zypp::Pathname _local;
+	std::chrono::steady_clock::time_point _start;
+	double _peak;
+};
+
+#endif // TransferStats_h
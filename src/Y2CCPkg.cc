@@ -29,6 +29,9 @@
 #include <y2/Y2Component.h>
 #include "Y2CCPkg.h"
 #include "Y2PkgComponent.h"
+#include "CallStats.h"
+
+#include <cstdlib>
 
 Y2Component *Y2CCPkg::createInLevel(const char *name, int level, int) const
 {
@@ -62,6 +65,12 @@ Y2Component* Y2CCPkg::provideNamespace(const char* name)
 Y2CCPkg::~Y2CCPkg()
 {
     y2debug("~Y2CCPkg");
+
+    // dump the builtin statistics if requested
+    const char *stats_file = ::getenv("Y2PKG_BUILTIN_STATS");
+    if (stats_file && *stats_file)
+	CallStats::instance().dump(stats_file);
+
     Y2PkgComponent::destroy();
 }
 
@@ -22,6 +22,8 @@
 
 
 #include "Y2PkgFunction.h"
+#include "CallStats.h"
+#include "AsyncLogWriter.h"
 
 #include <ycp/YCPBoolean.h>
 #include <ycp/YCPValue.h>
@@ -107,6 +109,9 @@
 
     void Y2PkgFunction::log_backtrace()
     {
+	// write the pending ZYPP log first, it might describe the problem
+	AsyncLogWriter::instance().flush();
+
 	// see 'man backtrace_symbols' for more details
 	#define BACKTRACE_BUFFER_SIZE 100
 	void *buffer[BACKTRACE_BUFFER_SIZE];
@@ -129,11 +134,39 @@
     {
 	ycpmilestone ("Pkg Builtin called: %s", name().c_str() );
 
+	// record the call count and the time of the builtin
+	CallStats::Timer timer(m_name);
+
+	// libzypp is not thread safe, do not touch it while an async operation is running
+	m_instance->AsyncWaitIdle(m_name);
+
+	// track the builtins called from the YCP callbacks (during a long operation)
+	struct Nesting
+	{
+	    Nesting(PkgFunctions *pkg) : _pkg(pkg), depth(pkg->BuiltinStarted()) {}
+	    ~Nesting() { _pkg->BuiltinFinished(); }
+	    PkgFunctions *_pkg;
+	    unsigned depth;
+	} nesting(m_instance);
+
 	try
 	{
-	    switch (m_position) {
+	    // the generated code returns directly from the switch
+	    YCPValue ret = [this]() -> YCPValue {
+		switch (m_position) {
 #include "PkgBuiltinCalls.h"
-	    }
+		}
+
+		return YCPNull();
+	    }();
+
+	    // deliver the events queued during the call, not on an exception
+	    // (the YCP callbacks must not be evaluated while unwinding),
+	    // a nested builtin must not drop the abort requested for the running operation
+	    if (nesting.depth == 1)
+		m_instance->FlushCallbackEvents();
+
+	    return ret;
 	}
 	catch (const std::exception& excpt)
 	{
@@ -26,13 +26,24 @@
 
 #include <YRepo.h>
 
-#define y2log_component "Pkg"
-#include <ycp/y2log.h>
+#include <algorithm>
+#include <sstream>
+
+// mediaAccess() is used also in the async operations
+#include "log.h"
 
 IMPL_PTR_TYPE(YRepo);
 
-YRepo::YRepo(zypp::RepoInfo & repo)
-    : _repo(repo), _deleted(false), _loaded(false)
+// the configuration as written to the .repo file
+static std::string asIni(const zypp::RepoInfo &repo)
+{
+    std::ostringstream str;
+    repo.dumpAsIniOn(str);
+    return str.str();
+}
+
+YRepo::YRepo(zypp::RepoInfo & repo, bool dirty)
+    : _repo(repo), _deleted(false), _loaded(false), _dirty(dirty), _saved(dirty ? std::string() : asIni(repo))
 {}
 
 YRepo::~YRepo()
@@ -51,13 +62,58 @@ zypp::MediaSetAccess_Ptr & YRepo::mediaAccess()
 {
     if (!_maccess)
     {
+        // the nearest server if the URLs have been ranked
+        zypp::Url url(_ranked_urls.empty() ? _repo.url() : _ranked_urls.front());
+
         y2milestone("Creating new MediaSetAccess for url %s",
-            _repo.url().asString().c_str());
-        _maccess = new zypp::MediaSetAccess(_repo.name(), _repo.url()); // FIXME handle multiple baseUrls
+            url.asString().c_str());
+        _maccess = new zypp::MediaSetAccess(_repo.name(), url); // FIXME handle multiple baseUrls
     }
 
     return _maccess;
 }
 
+bool YRepo::isDirty() const
+{
+    return _dirty || asIni(_repo) != _saved;
+}
+
+void YRepo::resetDirty()
+{
+    _dirty = false;
+    _saved = asIni(_repo);
+}
+
+zypp::RepoInfo YRepo::rankedRepoInfo() const
+{
+    zypp::RepoInfo ret(_repo);
+
+    if (!_ranked_urls.empty())
+	ret.setBaseUrls(_ranked_urls);
+
+    return ret;
+}
+
+void YRepo::setRankedUrls(const zypp::RepoInfo::url_set &urls)
+{
+    if (urls.size() == _ranked_urls.size() && std::equal(urls.begin(), urls.end(), _ranked_urls.begin(),
+	[](const zypp::Url &a, const zypp::Url &b) { return a.asCompleteString() == b.asCompleteString(); }))
+	return;
+
+    _ranked_urls = urls;
+
+    // the media access uses the first URL
+    if (_maccess)
+    {
+	try { _maccess->release(); }
+	catch (const zypp::media::MediaException & ex)
+	{
+	    y2error("Cannot release media: %s", ex.asString().c_str());
+	}
+
+	_maccess = NULL;
+    }
+}
+
 const YRepo YRepo::NOREPO;
 
@@ -28,6 +28,8 @@
 #ifndef YRepo_h
 #define YRepo_h
 
+#include <string>
+
 #include <zypp/RepoInfo.h>
 #include <zypp/MediaSetAccess.h>
 #include <zypp/base/ReferenceCounted.h>
@@ -40,17 +42,33 @@ private:
     zypp::MediaSetAccess_Ptr _maccess;
     bool _deleted;
     bool _loaded;
+    // explicitly marked as changed (e.g. a new repository, a new target)
+    bool _dirty;
+    // the configuration as read from/written to the .repo file (empty = not saved),
+    // the RepoInfo can be changed via the non-const repoInfo() accessor
+    std::string _saved;
+    // the base URLs ordered by the server latency (empty = the configured order),
+    // kept separately, the RepoInfo is saved to the .repo file
+    zypp::RepoInfo::url_set _ranked_urls;
 
     YRepo() {}
 
 public:
-    YRepo(zypp::RepoInfo & repo);
+    // dirty = false for a repository read from disk
+    YRepo(zypp::RepoInfo & repo, bool dirty = true);
     ~YRepo();
 
     const zypp::RepoInfo & repoInfo() const { return _repo; }
     zypp::RepoInfo & repoInfo() { return _repo; }
     zypp::MediaSetAccess_Ptr & mediaAccess();
 
+    // use the base URLs in the ranked order (the media access is recreated),
+    // the configured URLs are not changed
+    void setRankedUrls(const zypp::RepoInfo::url_set &urls);
+    // a copy of the RepoInfo with the base URLs in the ranked order for refreshing
+    // and loading into the pool, it must not be saved (it contains the expanded URLs)
+    zypp::RepoInfo rankedRepoInfo() const;
+
     bool isDeleted() {return _deleted;}
     void setDeleted() {_deleted = true;}
 
@@ -58,6 +76,12 @@ public:
     void setLoaded() {_loaded = true;}
     void resetLoaded() {_loaded = false;}
 
+    // the configuration differs from the saved .repo file
+    bool isDirty() const;
+    void setDirty() {_dirty = true;}
+    // the current configuration has been saved
+    void resetDirty();
+
 public:
     static const YRepo NOREPO;
 };
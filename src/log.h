@@ -2,3 +2,177 @@
 #define y2log_component "Pkg"
 #include <y2util/y2log.h>
 
+#ifndef Pkg_log_h
+#define Pkg_log_h
+
+#include <climits>
+#include <cstdlib>
+#include <string>
+#include <time.h>
+
+// y2log is not thread safe, the messages logged from the other threads than
+// the main one (the async operations, the copy and the cleanup threads) are
+// formatted here and written via the AsyncLogWriter queue
+bool y2_log_in_thread();
+void y2_logger_thread(loglevel_t level, const char *component, const char *file,
+    int line, const char *func, const char *format, ...) __attribute__ ((format (printf, 6, 7)));
+
+#undef y2_logger
+#define y2_logger(level, comp, format, args...)					\
+    do {									\
+	if (should_be_logged(level, comp))					\
+	{									\
+	    if (y2_log_in_thread())						\
+		y2_logger_thread(level, comp, __FILE__, __LINE__, __FUNCTION__, format, ##args); \
+	    else								\
+		y2_logger_function(level, comp, __FILE__, __LINE__, __FUNCTION__, format, ##args); \
+	}									\
+    } while (0)
+
+/**
+ * Limits the number of logged per item messages in a loop, the rest is
+ * summarized by a single "N similar messages suppressed" line at the end.
+ *
+ * The limit can be changed by the Y2PKG_LOG_ITEMS environment variable,
+ * Y2PKG_LOG_ITEMS=0 logs only the summary line. Everything is logged
+ * when y2log debugging is enabled.
+ *
+ * Example:
+ *   LogBudget budget("patch");
+ *   for (...)
+ *       if (budget.allow()) y2milestone("Processing patch %s", name);
+ */
+class LogBudget
+{
+    public:
+
+	LogBudget(const char *what, unsigned limit = defaultLimit())
+	    : _what(what), _limit(get_log_debug() ? UINT_MAX : limit), _count(0)
+	{}
+
+	~LogBudget()
+	{
+	    if (_count > _limit)
+		y2milestone("%u similar %s messages suppressed (%u total)",
+		    _count - _limit, _what, _count);
+	}
+
+	// is the next message allowed?
+	bool allow()
+	{
+	    return ++_count <= _limit;
+	}
+
+	// the default number of logged items (10), an invalid
+	// Y2PKG_LOG_ITEMS value is ignored
+	static unsigned defaultLimit()
+	{
+	    static unsigned limit = UINT_MAX;
+
+	    if (limit == UINT_MAX)
+	    {
+		limit = 10;
+		const char *env = ::getenv("Y2PKG_LOG_ITEMS");
+
+		if (env)
+		{
+		    char *end = NULL;
+		    unsigned long value = ::strtoul(env, &end, 10);
+
+		    if (end != env && *end == '\0' && *env != '-' && value < UINT_MAX)
+			limit = value;
+		    else
+			y2warning("Ignoring invalid Y2PKG_LOG_ITEMS value: %s", env);
+		}
+	    }
+
+	    return limit;
+	}
+
+    private:
+
+	const char *_what;
+	unsigned _limit;
+	unsigned _count;
+};
+
+/**
+ * Time based rate limit for a message, see y2milestone_ratelimited(),
+ * the number of the suppressed messages is logged with the next allowed
+ * message or by reset() or the destructor.
+ */
+class LogRateLimit
+{
+    public:
+
+	LogRateLimit(unsigned interval_ms)
+	    : _interval(interval_ms), _last(0), _suppressed(0)
+	{}
+
+	~LogRateLimit()
+	{
+	    reset();
+	}
+
+	// is the next message allowed? (a forced one is always allowed)
+	bool allow(bool force = false)
+	{
+	    unsigned long long now = nowMs();
+
+	    if (force || _last == 0 || now - _last >= _interval || get_log_debug())
+	    {
+		_last = now;
+		return true;
+	    }
+
+	    ++_suppressed;
+	    return false;
+	}
+
+	// log the suppressed messages, the next message is allowed
+	void reset()
+	{
+	    unsigned count = suppressed();
+	    if (count > 0)
+		y2milestone("(%u similar messages suppressed)", count);
+
+	    _last = 0;
+	}
+
+	// the number of suppressed messages since the last allowed one, resets the counter
+	unsigned suppressed()
+	{
+	    unsigned ret = _suppressed;
+	    _suppressed = 0;
+	    return ret;
+	}
+
+    private:
+
+	static unsigned long long nowMs()
+	{
+	    struct timespec ts;
+	    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+	    return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000 + 1;
+	}
+
+	unsigned _interval;
+	unsigned long long _last;
+	unsigned _suppressed;
+};
+
+// log a milestone at most once per interval of the LogRateLimit object
+// (always if "force" is true), the arguments are not evaluated when
+// the message is suppressed
+#define y2milestone_ratelimited(limit, force, format, args...)			\
+    do {									\
+	if ((limit).allow(force))						\
+	{									\
+	    unsigned _log_suppressed = (limit).suppressed();			\
+	    if (_log_suppressed > 0)						\
+		y2milestone("(%u similar messages suppressed)", _log_suppressed); \
+	    y2milestone(format, ##args);					\
+	}									\
+    } while (0)
+
+#endif // Pkg_log_h